@@ -1,9 +1,13 @@
 include(../../gtest.pri)
 
 TEMPLATE = app
-CONFIG += console c++11
+CONFIG += console c++17 thread
 CONFIG -= app_bundle
 CONFIG -= qt
 
 SOURCES += \
     test.cpp
+
+HEADERS += \
+    BankOcr.h \
+    BankOcrTestSupport.h
@@ -0,0 +1,965 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <iterator>
+#include <functional>
+#include <stdexcept>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include <fstream>
+#include <cstring>
+#include <cstdint>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BANK_OCR_AVX2
+#include <immintrin.h>
+#endif
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+const unsigned short g_linesInDigit = 3;
+struct Digit
+{
+    std::string lines[3];
+};
+
+const unsigned short g_digitsOnDisplay = 9;
+struct Display
+{
+    std::string lines[3];
+};
+
+const Digit s_digit0 = { " _ ",
+                         "| |",
+                         "|_|"
+                       };
+const Digit s_digit1 = { "   ",
+                         "  |",
+                         "  |"
+                       };
+const Digit s_digit2 = { " _ ",
+                         " _|",
+                         "|_ "
+                       };
+const Digit s_digit3 = { " _ ",
+                         " _|",
+                         " _|"
+                       };
+const Digit s_digit4 = { "   ",
+                         "|_|",
+                         "  |"
+                       };
+const Digit s_digit5 = { " _ ",
+                         "|_ ",
+                         " _|"
+                       };
+const Digit s_digit6 = { " _ ",
+                         "|_ ",
+                         "|_|"
+                       };
+const Digit s_digit7 = { " _ ",
+                         "  |",
+                         "  |"
+                       };
+const Digit s_digit8 = { " _ ",
+                         "|_|",
+                         "|_|"
+                       };
+const Digit s_digit9 = { " _ ",
+                         "|_|",
+                         " _|"
+                       };
+// Segment mask of a glyph: bit (row * 3 + column) is set when the cell holds the segment of that place.
+// Bit g_straySymbolBit marks a cell holding a symbol that no digit has in that place.
+const unsigned short g_glyphMaskSize = 512;
+const unsigned short g_straySymbolBit = 1 << 9;
+const char g_segmentSymbols[] = " _ |_||_|";
+
+// Glyphs of the digits 0-9, rows concatenated
+const char g_glyphPatterns[10][10] = {" _ | ||_|", "     |  |", " _  _||_ ", " _  _| _|", "   |_|  |",
+                                      " _ |_  _|", " _ |_ |_|", " _   |  |", " _ |_||_|", " _ |_| _|"};
+
+struct GlyphTable
+{
+    signed char digits[g_glyphMaskSize];
+};
+
+constexpr unsigned short GlyphPatternMask(const char* pattern)
+{
+    unsigned short mask = 0;
+    for (int cell = 0; cell < 9; ++cell)
+    {
+        mask |= (pattern[cell] != ' ') << cell;
+    }
+    return mask;
+}
+
+constexpr GlyphTable MakeGlyphTable()
+{
+    GlyphTable table{};
+    for (int mask = 0; mask < g_glyphMaskSize; ++mask)
+    {
+        table.digits[mask] = -1;
+    }
+    for (int digit = 0; digit < 10; ++digit)
+    {
+        table.digits[GlyphPatternMask(g_glyphPatterns[digit])] = static_cast<signed char>(digit);
+    }
+    return table;
+}
+
+constexpr GlyphTable s_glyphTable = MakeGlyphTable();
+
+// strayCells, when given, receives the number of cells with a stray symbol
+inline unsigned short ZipGlyphMask(const char* top, const char* middle, const char* bottom, int* strayCells = nullptr)
+{
+    const char* rows[g_linesInDigit] = {top, middle, bottom};
+    unsigned short mask = 0;
+    unsigned short stray = 0;
+    for (int row = 0; row < g_linesInDigit; ++row)
+    {
+        for (int column = 0; column < 3; ++column)
+        {
+            const int cell = row * 3 + column;
+            const char symbol = rows[row][column];
+            const unsigned short filled = symbol != ' ';
+            const unsigned short segment = filled & (symbol == g_segmentSymbols[cell]);
+            mask |= segment << cell;
+            stray += filled & !segment;
+        }
+    }
+    if (strayCells != nullptr)
+    {
+        *strayCells = stray;
+    }
+    return mask | (stray ? g_straySymbolBit : 0);
+}
+
+inline int ZipGlyphParser(const char* top, const char* middle, const char* bottom)
+{
+    const unsigned short mask = ZipGlyphMask(top, middle, bottom);
+    return (mask & g_straySymbolBit) ? -1 : s_glyphTable.digits[mask];
+}
+
+inline int ZipNumberParser(const Digit& digit)
+{
+    if (digit.lines[0].size() != 3 || digit.lines[1].size() != 3 || digit.lines[2].size() != 3)
+    {
+        return -1;
+    }
+    return ZipGlyphParser(digit.lines[0].data(), digit.lines[1].data(), digit.lines[2].data());
+}
+
+// Previous linear scan over all digits, kept as a reference for the table decoder
+inline bool CompareDigits(const Digit& left, const Digit& right)
+{
+    return left.lines[0] == right.lines[0] && left.lines[1] == right.lines[1] && left.lines[2] == right.lines[2];
+}
+
+inline int ZipNumberParserByScan(const Digit& digit)
+{
+    std::vector<Digit> allNumbers;
+    allNumbers.reserve(10);
+    allNumbers.push_back(s_digit0);
+    allNumbers.push_back(s_digit1);
+    allNumbers.push_back(s_digit2);
+    allNumbers.push_back(s_digit3);
+    allNumbers.push_back(s_digit4);
+    allNumbers.push_back(s_digit5);
+    allNumbers.push_back(s_digit6);
+    allNumbers.push_back(s_digit7);
+    allNumbers.push_back(s_digit8);
+    allNumbers.push_back(s_digit9);
+
+    for (size_t i = 0; i < allNumbers.size(); ++i)
+    {
+        if ( CompareDigits(digit, allNumbers[i]) )
+        {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+const unsigned short g_symbolsInLine = 27;
+const unsigned short g_symbolsInDigit = 3;
+
+// Batch decoder for the three 27-symbol rows of a display.
+// Fills digits with nine values, -1 for illegible glyphs.
+inline void ZipRowsDecoderScalar(const char* top, const char* middle, const char* bottom, int* digits)
+{
+    for (int i = 0; i < g_digitsOnDisplay; ++i)
+    {
+        const int offset = i * g_symbolsInDigit;
+        digits[i] = ZipGlyphParser(top + offset, middle + offset, bottom + offset);
+    }
+}
+
+#ifdef BANK_OCR_AVX2
+// Cells of the middle column of every glyph, where only '_' is expected
+const unsigned int g_middleColumns = 0x2492492;
+const unsigned int g_allColumns = (1u << g_symbolsInLine) - 1;
+
+__attribute__((target("avx2")))
+inline void ZipRowsDecoderAvx2(const char* top, const char* middle, const char* bottom, int* digits)
+{
+    const char* rows[g_linesInDigit] = {top, middle, bottom};
+    unsigned int segments[g_linesInDigit];
+    unsigned int stray[g_linesInDigit];
+    for (int row = 0; row < g_linesInDigit; ++row)
+    {
+        alignas(32) char buffer[32];
+        std::memset(buffer + g_symbolsInLine, ' ', sizeof(buffer) - g_symbolsInLine);
+        std::memcpy(buffer, rows[row], g_symbolsInLine); // rows are not padded up to 32 bytes
+
+        const __m256i symbols = _mm256_load_si256(reinterpret_cast<const __m256i*>(buffer));
+        const unsigned int spaces = _mm256_movemask_epi8(_mm256_cmpeq_epi8(symbols, _mm256_set1_epi8(' ')));
+        const unsigned int underscores = _mm256_movemask_epi8(_mm256_cmpeq_epi8(symbols, _mm256_set1_epi8('_')));
+        const unsigned int pipes = _mm256_movemask_epi8(_mm256_cmpeq_epi8(symbols, _mm256_set1_epi8('|')));
+
+        // The top row has no vertical segments, so every non-blank side cell is stray there
+        const unsigned int sides = row == 0 ? 0 : g_allColumns & ~g_middleColumns;
+        segments[row] = (underscores & g_middleColumns) | (pipes & sides);
+        stray[row] = ~spaces & g_allColumns & ~segments[row];
+    }
+
+    for (int i = 0; i < g_digitsOnDisplay; ++i)
+    {
+        const int shift = i * g_symbolsInDigit;
+        const unsigned int mask = ((segments[0] >> shift) & 7) | (((segments[1] >> shift) & 7) << 3) |
+                                  (((segments[2] >> shift) & 7) << 6);
+        const unsigned int strayCells = ((stray[0] | stray[1] | stray[2]) >> shift) & 7;
+        digits[i] = strayCells ? -1 : s_glyphTable.digits[mask];
+    }
+}
+
+inline bool HasAvx2()
+{
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+    return hasAvx2;
+}
+#endif
+
+inline void ZipRowsDecoder(const char* top, const char* middle, const char* bottom, int* digits)
+{
+#ifdef BANK_OCR_AVX2
+    if (HasAvx2())
+    {
+        ZipRowsDecoderAvx2(top, middle, bottom, digits);
+        return;
+    }
+#endif
+    ZipRowsDecoderScalar(top, middle, bottom, digits);
+}
+
+inline std::string ZipLinesParser(std::string_view top, std::string_view middle, std::string_view bottom)
+{
+    if (top.size() != g_symbolsInLine || middle.size() != g_symbolsInLine || bottom.size() != g_symbolsInLine)
+    {
+        return "-1";
+    }
+    int digits[g_digitsOnDisplay];
+    ZipRowsDecoder(top.data(), middle.data(), bottom.data(), digits);
+    std::string answer(g_digitsOnDisplay, '0');
+    for (int i = 0; i < g_digitsOnDisplay; ++i)
+    {
+        if (digits[i] == -1)
+        {
+            return "-1";
+        }
+        answer[i] = static_cast<char>('0' + digits[i]);
+    }
+    return answer;
+}
+
+inline std::string ZipBatchLineParser(const Display& display)
+{
+    return ZipLinesParser(display.lines[0], display.lines[1], display.lines[2]);
+}
+
+// Writes nine digit symbols into answer, returns false for a wrong display.
+// Glyph columns are read through views of the display lines, so nothing is allocated.
+inline bool ZipLineToBuffer(const Display& display, char* answer)
+{
+    const std::string_view lines[g_linesInDigit] = {display.lines[0], display.lines[1], display.lines[2]};
+    if (lines[0].size() != g_symbolsInLine || lines[1].size() != g_symbolsInLine || lines[2].size() != g_symbolsInLine)
+    {
+        return false;
+    }
+    for (int i = 0; i < g_digitsOnDisplay; ++i)
+    {
+        const size_t offset = i * g_symbolsInDigit;
+        int temp = ZipGlyphParser(lines[0].substr(offset, g_symbolsInDigit).data(),
+                                  lines[1].substr(offset, g_symbolsInDigit).data(),
+                                  lines[2].substr(offset, g_symbolsInDigit).data());
+        if(temp == -1)
+        {
+            return false;
+        }
+        answer[i] = static_cast<char>('0' + temp);
+    }
+    return true;
+}
+
+inline bool ZipLineParser(const Display& display, std::array<char, g_digitsOnDisplay>& answer)
+{
+    return ZipLineToBuffer(display, answer.data());
+}
+
+inline bool ZipLineParser(const Display& display, char (&answer)[g_digitsOnDisplay])
+{
+    return ZipLineToBuffer(display, answer);
+}
+
+inline std::string ZipLineParser(const Display& display)
+{
+    std::array<char, g_digitsOnDisplay> answer;
+    if (!ZipLineParser(display, answer))
+    {
+        return "-1";
+    }
+    return std::string(answer.begin(), answer.end());
+}
+
+inline std::vector<std::string> ZipVectorParser(const std::vector<Display>& displays)
+{
+    std::vector<std::string> answer;
+    answer.reserve(displays.size());
+    for(const auto& disp:displays)
+    {
+        answer.push_back(ZipBatchLineParser(disp));
+    }
+    return answer;
+}
+
+// Parallel mode of ZipVectorParser.
+// Workers take chunks of entries one after another and store every account at
+// the index of its entry, so the answer keeps the original order.
+const size_t g_entriesInChunk = 4096;
+
+inline std::vector<std::string> ZipParallelVectorParser(const std::vector<Display>& displays, unsigned threadsCount = 0)
+{
+    if (threadsCount == 0)
+    {
+        threadsCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    const size_t chunksCount = (displays.size() + g_entriesInChunk - 1) / g_entriesInChunk;
+    threadsCount = static_cast<unsigned>(std::min<size_t>(threadsCount, chunksCount));
+
+    std::vector<std::string> answer(displays.size());
+    std::atomic<size_t> nextChunk(0);
+    auto worker = [&displays, &answer, &nextChunk, chunksCount]()
+    {
+        for (size_t chunk = nextChunk++; chunk < chunksCount; chunk = nextChunk++)
+        {
+            const size_t end = std::min(displays.size(), (chunk + 1) * g_entriesInChunk);
+            for (size_t i = chunk * g_entriesInChunk; i < end; ++i)
+            {
+                answer[i] = ZipBatchLineParser(displays[i]);
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned i = 1; i < threadsCount; ++i)
+    {
+        pool.emplace_back(worker);
+    }
+    worker(); // the calling thread is a worker too
+    for (std::thread& thread : pool)
+    {
+        thread.join();
+    }
+    return answer;
+}
+
+// Account numbers with checksum verdict.
+// Status follows the output of the kata: ILL for an illegible digit, ERR for a wrong checksum.
+enum class AccountStatus
+{
+    Ok,
+    Illegible,
+    Error,
+    Ambiguous
+};
+
+struct AccountResult
+{
+    std::array<int, g_digitsOnDisplay> digits; // -1 for an illegible digit
+    bool checksumValid;
+    AccountStatus status;
+};
+
+// Valid account: (d1 + 2*d2 + 3*d3 + ... + 9*d9) mod 11 == 0, where d1 is the rightmost digit
+inline AccountResult ZipAccountLinesParser(std::string_view top, std::string_view middle, std::string_view bottom)
+{
+    AccountResult result;
+    result.digits.fill(-1);
+    result.checksumValid = false;
+    result.status = AccountStatus::Illegible;
+    if (top.size() != g_symbolsInLine || middle.size() != g_symbolsInLine || bottom.size() != g_symbolsInLine)
+    {
+        return result;
+    }
+
+    ZipRowsDecoder(top.data(), middle.data(), bottom.data(), result.digits.data());
+    int illegible = 0;
+    int checksum = 0;
+    for (int i = 0; i < g_digitsOnDisplay; ++i)
+    {
+        illegible |= result.digits[i] < 0;
+        checksum += result.digits[i] * (g_digitsOnDisplay - i);
+    }
+    result.checksumValid = !illegible && checksum % 11 == 0;
+    result.status = illegible ? AccountStatus::Illegible
+                              : result.checksumValid ? AccountStatus::Ok : AccountStatus::Error;
+    return result;
+}
+
+inline AccountResult ZipAccountParser(const Display& display)
+{
+    return ZipAccountLinesParser(display.lines[0], display.lines[1], display.lines[2]);
+}
+
+inline std::vector<AccountResult> ZipVectorAccountParser(const std::vector<Display>& displays)
+{
+    std::vector<AccountResult> answer;
+    answer.reserve(displays.size());
+    for (const Display& display : displays)
+    {
+        answer.push_back(ZipAccountParser(display));
+    }
+    return answer;
+}
+
+// Formats the result as "457508000", "664371495 ERR" or "86110??36 ILL"
+inline std::string ToString(const AccountResult& result)
+{
+    std::string answer(g_digitsOnDisplay, '?');
+    for (int i = 0; i < g_digitsOnDisplay; ++i)
+    {
+        if (result.digits[i] >= 0)
+        {
+            answer[i] = static_cast<char>('0' + result.digits[i]);
+        }
+    }
+    switch (result.status)
+    {
+    case AccountStatus::Illegible:
+        return answer + " ILL";
+    case AccountStatus::Error:
+        return answer + " ERR";
+    case AccountStatus::Ambiguous:
+        return answer + " AMB";
+    default:
+        return answer;
+    }
+}
+
+// Error correction.
+// A digit could be misread because of one missing or extra segment, so the candidates for
+// a glyph are the digits whose segment masks differ from it in exactly one cell.
+struct GlyphNeighbours
+{
+    unsigned short digits[g_glyphMaskSize]; // bit d is set for every candidate digit d
+};
+
+constexpr int CountBits(unsigned int value)
+{
+    int count = 0;
+    for (; value != 0; value &= value - 1)
+    {
+        ++count;
+    }
+    return count;
+}
+
+constexpr GlyphNeighbours MakeGlyphNeighbours()
+{
+    GlyphNeighbours neighbours{};
+    for (int mask = 0; mask < g_glyphMaskSize; ++mask)
+    {
+        for (int digit = 0; digit < 10; ++digit)
+        {
+            const bool oneFlipAway = CountBits(mask ^ GlyphPatternMask(g_glyphPatterns[digit])) == 1;
+            neighbours.digits[mask] |= oneFlipAway << digit;
+        }
+    }
+    return neighbours;
+}
+
+constexpr GlyphNeighbours s_glyphNeighbours = MakeGlyphNeighbours();
+
+struct CorrectedAccount
+{
+    AccountResult account;
+    std::vector<std::array<int, g_digitsOnDisplay>> alternatives; // checksum-valid candidates of an AMB account
+};
+
+// Fixes an ILL account with one illegible digit or an ERR account when exactly one
+// single-segment change passes the checksum; several such changes give an AMB account.
+inline CorrectedAccount ZipAccountCorrector(const Display& display)
+{
+    CorrectedAccount corrected{ZipAccountParser(display), {}};
+    AccountResult& account = corrected.account;
+    if (account.status == AccountStatus::Ok ||
+        display.lines[0].size() != g_symbolsInLine ||
+        display.lines[1].size() != g_symbolsInLine ||
+        display.lines[2].size() != g_symbolsInLine)
+    {
+        return corrected;
+    }
+
+    int checksum = 0;
+    int illegibleCount = 0;
+    int illegiblePosition = 0;
+    for (int i = 0; i < g_digitsOnDisplay; ++i)
+    {
+        const bool illegible = account.digits[i] < 0;
+        illegibleCount += illegible;
+        illegiblePosition = illegible ? i : illegiblePosition;
+        checksum += illegible ? 0 : account.digits[i] * (g_digitsOnDisplay - i);
+    }
+    if (illegibleCount > 1)
+    {
+        return corrected;
+    }
+
+    const int first = illegibleCount == 1 ? illegiblePosition : 0;
+    const int last = illegibleCount == 1 ? illegiblePosition + 1 : g_digitsOnDisplay;
+    for (int i = first; i < last; ++i)
+    {
+        const int offset = i * g_symbolsInDigit;
+        const int digit = account.digits[i];
+        int strayCells = 0;
+        const unsigned short mask = digit < 0 ? ZipGlyphMask(display.lines[0].data() + offset,
+                                                             display.lines[1].data() + offset,
+                                                             display.lines[2].data() + offset, &strayCells)
+                                              : GlyphPatternMask(g_glyphPatterns[digit]);
+        // A single stray symbol is corrected by blanking it, so the only candidate is the digit
+        // left without it. With two or more every digit is at least two changes away.
+        unsigned short candidates = 0;
+        if (strayCells == 0)
+        {
+            candidates = s_glyphNeighbours.digits[mask];
+        }
+        else if (strayCells == 1)
+        {
+            const int hidden = s_glyphTable.digits[mask & ~g_straySymbolBit];
+            candidates = hidden >= 0 ? 1 << hidden : 0;
+        }
+        for (int candidate = 0; candidate < 10; ++candidate)
+        {
+            const int changed = checksum + (candidate - std::max(digit, 0)) * (g_digitsOnDisplay - i);
+            if (((candidates >> candidate) & 1) && changed % 11 == 0)
+            {
+                corrected.alternatives.push_back(account.digits);
+                corrected.alternatives.back()[i] = candidate;
+            }
+        }
+    }
+
+    if (corrected.alternatives.size() == 1)
+    {
+        account.digits = corrected.alternatives.front();
+        account.checksumValid = true;
+        account.status = AccountStatus::Ok;
+        corrected.alternatives.clear();
+    }
+    else if (corrected.alternatives.size() > 1)
+    {
+        account.status = AccountStatus::Ambiguous;
+        std::sort(corrected.alternatives.begin(), corrected.alternatives.end());
+    }
+    return corrected;
+}
+
+// Formats an AMB account as "888888888 AMB ['888886888', '888888880', '888888988']"
+inline std::string ToString(const CorrectedAccount& corrected)
+{
+    std::string answer = ToString(corrected.account);
+    if (corrected.alternatives.empty())
+    {
+        return answer;
+    }
+    answer += " [";
+    for (size_t i = 0; i < corrected.alternatives.size(); ++i)
+    {
+        answer += i == 0 ? "'" : ", '";
+        for (int digit : corrected.alternatives[i])
+        {
+            answer += static_cast<char>('0' + digit);
+        }
+        answer += "'";
+    }
+    return answer + "]";
+}
+
+// Streaming parser for the raw scan file.
+// The file is mapped into memory and every 4-line entry (3 lines of glyphs and
+// a blank separator) is decoded in place, without building Display objects.
+
+using AccountCallback = std::function<void(const std::string& account)>;
+
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::string& path)
+        : m_data(nullptr)
+        , m_size(0)
+    {
+#ifdef _WIN32
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+        {
+            throw std::runtime_error("Failed to open scan file: " + path);
+        }
+        m_buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        m_data = m_buffer.data();
+        m_size = m_buffer.size();
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd == -1)
+        {
+            throw std::runtime_error("Failed to open scan file: " + path);
+        }
+        struct stat info;
+        if (::fstat(fd, &info) == -1)
+        {
+            ::close(fd);
+            throw std::runtime_error("Failed to stat scan file: " + path);
+        }
+        m_size = static_cast<size_t>(info.st_size);
+        if (m_size != 0)
+        {
+            void* mapping = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping == MAP_FAILED)
+            {
+                ::close(fd);
+                throw std::runtime_error("Failed to map scan file: " + path);
+            }
+            ::madvise(mapping, m_size, MADV_SEQUENTIAL);
+            m_data = static_cast<const char*>(mapping);
+        }
+        ::close(fd); // The mapping stays valid after the descriptor is closed
+#endif
+    }
+
+    ~MappedFile()
+    {
+#ifndef _WIN32
+        if (m_data != nullptr)
+        {
+            ::munmap(const_cast<char*>(m_data), m_size);
+        }
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* Data() const { return m_data; }
+    size_t Size() const { return m_size; }
+
+private:
+    const char* m_data;
+    size_t m_size;
+#ifdef _WIN32
+    std::vector<char> m_buffer;
+#endif
+};
+
+// Cuts the next line from [position, end) and moves position past its '\n'.
+inline std::string_view NextLine(const char*& position, const char* end)
+{
+    const char* lineEnd = static_cast<const char*>(std::memchr(position, '\n', end - position));
+    if (lineEnd == nullptr)
+    {
+        lineEnd = end;
+    }
+    std::string_view line(position, lineEnd - position);
+    if (!line.empty() && line.back() == '\r')
+    {
+        line.remove_suffix(1);
+    }
+    position = lineEnd == end ? end : lineEnd + 1;
+    return line;
+}
+
+// Decodes every entry of the raw scan buffer and returns the number of entries.
+inline size_t ZipStreamParser(const char* data, size_t size, const AccountCallback& onAccount)
+{
+    const char* position = data;
+    const char* end = data + size;
+    size_t entries = 0;
+    while (position != end)
+    {
+        std::string_view top = NextLine(position, end);
+        std::string_view middle = position != end ? NextLine(position, end) : std::string_view();
+        std::string_view bottom = position != end ? NextLine(position, end) : std::string_view();
+        if (position != end)
+        {
+            NextLine(position, end); // blank separator
+        }
+        if (top.empty() && middle.empty() && bottom.empty())
+        {
+            continue; // extra empty lines between or after entries are not an entry
+        }
+        onAccount(ZipLinesParser(top, middle, bottom));
+        ++entries;
+    }
+    return entries;
+}
+
+inline size_t ZipFileParser(const std::string& path, const AccountCallback& onAccount)
+{
+    MappedFile file(path);
+    return ZipStreamParser(file.Data(), file.Size(), onAccount);
+}
+
+// Push-style parser for scans that arrive in chunks.
+// Only the current entry is kept between calls: three rows of 27 symbols and the
+// length of every line seen so far. An account is reported as soon as the line
+// after its third row (the blank separator) ends.
+class ZipIncrementalParser
+{
+public:
+    explicit ZipIncrementalParser(const AccountCallback& onAccount)
+        : m_onAccount(onAccount)
+        , m_line(0)
+        , m_lastSymbol(0)
+        , m_entries(0)
+    {
+        std::fill(std::begin(m_lengths), std::end(m_lengths), 0);
+    }
+
+    // Takes any piece of the scan, lines may be split between calls
+    void Feed(const char* data, size_t size)
+    {
+        while (size != 0)
+        {
+            const char* newline = static_cast<const char*>(std::memchr(data, '\n', size));
+            const size_t segment = newline == nullptr ? size : newline - data;
+            Append(data, segment);
+            if (newline == nullptr)
+            {
+                return;
+            }
+            EndLine();
+            data += segment + 1;
+            size -= segment + 1;
+        }
+    }
+
+    // Reports the last entry when the scan ends without its separator
+    void Finish()
+    {
+        if (m_lengths[m_line] != 0)
+        {
+            EndLine();
+        }
+        Emit();
+    }
+
+    size_t Entries() const
+    {
+        return m_entries;
+    }
+
+private:
+    void Append(const char* data, size_t size)
+    {
+        if (size == 0)
+        {
+            return;
+        }
+        if (m_line < g_linesInDigit && m_lengths[m_line] < g_symbolsInLine)
+        {
+            const size_t room = g_symbolsInLine - m_lengths[m_line];
+            std::memcpy(m_rows[m_line] + m_lengths[m_line], data, std::min(room, size));
+        }
+        m_lengths[m_line] += size;
+        m_lastSymbol = data[size - 1];
+    }
+
+    void EndLine()
+    {
+        if (m_lastSymbol == '\r' && m_lengths[m_line] != 0)
+        {
+            --m_lengths[m_line];
+        }
+        m_lastSymbol = 0;
+        if (++m_line > g_linesInDigit)
+        {
+            Emit();
+        }
+    }
+
+    // Three empty rows are not an entry, like in ZipStreamParser
+    void Emit()
+    {
+        const bool blankRows = m_lengths[0] == 0 && m_lengths[1] == 0 && m_lengths[2] == 0;
+        if (blankRows)
+        {
+            m_line = 0;
+            m_lengths[g_linesInDigit] = 0;
+            return;
+        }
+        const bool fullRows = m_lengths[0] == g_symbolsInLine &&
+                              m_lengths[1] == g_symbolsInLine &&
+                              m_lengths[2] == g_symbolsInLine;
+        m_onAccount(fullRows ? ZipLinesParser(std::string_view(m_rows[0], g_symbolsInLine),
+                                              std::string_view(m_rows[1], g_symbolsInLine),
+                                              std::string_view(m_rows[2], g_symbolsInLine))
+                             : std::string("-1"));
+        ++m_entries;
+        m_line = 0;
+        std::fill(std::begin(m_lengths), std::end(m_lengths), 0);
+    }
+
+private:
+    AccountCallback m_onAccount;
+    char m_rows[g_linesInDigit][g_symbolsInLine];
+    size_t m_lengths[g_linesInDigit + 1]; // the last one is the separator
+    int m_line;
+    char m_lastSymbol;
+    size_t m_entries;
+};
+
+// Compact storage of decoded accounts.
+// Every account is kept as a 32-bit number plus 2 status bits (4 entries per byte).
+// Illegible digits are stored as 0, the status tells such accounts apart.
+const unsigned short g_statusBits = 2;
+const unsigned short g_statusesInByte = 8 / g_statusBits;
+
+struct AccountBatch
+{
+    std::vector<uint32_t> accounts;
+    std::vector<uint8_t> statuses;
+
+    size_t Size() const
+    {
+        return accounts.size();
+    }
+
+    AccountStatus Status(size_t index) const
+    {
+        const int shift = (index % g_statusesInByte) * g_statusBits;
+        return static_cast<AccountStatus>((statuses[index / g_statusesInByte] >> shift) & 3);
+    }
+
+    void Add(const AccountResult& result)
+    {
+        uint32_t account = 0;
+        for (int digit : result.digits)
+        {
+            account = account * 10 + static_cast<uint32_t>(std::max(digit, 0));
+        }
+        const size_t index = accounts.size();
+        if (index % g_statusesInByte == 0)
+        {
+            statuses.push_back(0);
+        }
+        statuses.back() |= static_cast<uint8_t>(result.status) << ((index % g_statusesInByte) * g_statusBits);
+        accounts.push_back(account);
+    }
+};
+
+inline AccountBatch ZipBatchAccountParser(const std::vector<Display>& displays)
+{
+    AccountBatch batch;
+    batch.accounts.reserve(displays.size());
+    batch.statuses.reserve((displays.size() + g_statusesInByte - 1) / g_statusesInByte);
+    for (const Display& display : displays)
+    {
+        batch.Add(ZipAccountParser(display));
+    }
+    return batch;
+}
+
+// Flat file layout, native byte order:
+//   0   4  magic "BOCR"
+//   4   4  format version
+//   8   8  number of accounts N
+//   16  4N accounts
+//   ..  (N + 3) / 4 status bytes
+const char g_batchMagic[4] = {'B', 'O', 'C', 'R'};
+const uint32_t g_batchVersion = 1;
+const size_t g_batchHeaderSize = 16;
+
+inline void WriteAccountBatch(const AccountBatch& batch, const std::string& path)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        throw std::runtime_error("Failed to create account batch file: " + path);
+    }
+    const uint64_t count = batch.Size();
+    file.write(g_batchMagic, sizeof(g_batchMagic));
+    file.write(reinterpret_cast<const char*>(&g_batchVersion), sizeof(g_batchVersion));
+    file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    file.write(reinterpret_cast<const char*>(batch.accounts.data()), batch.accounts.size() * sizeof(uint32_t));
+    file.write(reinterpret_cast<const char*>(batch.statuses.data()), batch.statuses.size());
+    if (!file.flush())
+    {
+        throw std::runtime_error("Failed to write account batch file: " + path);
+    }
+}
+
+// Read-only view over a mapped batch file, nothing is copied
+class AccountBatchView
+{
+public:
+    explicit AccountBatchView(const std::string& path)
+        : m_file(path)
+        , m_size(0)
+    {
+        uint32_t version = 0;
+        uint64_t count = 0;
+        if (m_file.Size() < g_batchHeaderSize || std::memcmp(m_file.Data(), g_batchMagic, sizeof(g_batchMagic)) != 0)
+        {
+            throw std::runtime_error("Not an account batch file: " + path);
+        }
+        std::memcpy(&version, m_file.Data() + 4, sizeof(version));
+        std::memcpy(&count, m_file.Data() + 8, sizeof(count));
+        if (version != g_batchVersion ||
+            count > (m_file.Size() - g_batchHeaderSize) / sizeof(uint32_t) ||
+            m_file.Size() != g_batchHeaderSize + count * sizeof(uint32_t) + (count + g_statusesInByte - 1) / g_statusesInByte)
+        {
+            throw std::runtime_error("Broken account batch file: " + path);
+        }
+        m_size = static_cast<size_t>(count);
+    }
+
+    size_t Size() const
+    {
+        return m_size;
+    }
+
+    uint32_t Account(size_t index) const
+    {
+        uint32_t account;
+        std::memcpy(&account, m_file.Data() + g_batchHeaderSize + index * sizeof(uint32_t), sizeof(account));
+        return account;
+    }
+
+    AccountStatus Status(size_t index) const
+    {
+        const char* statuses = m_file.Data() + g_batchHeaderSize + m_size * sizeof(uint32_t);
+        const int shift = (index % g_statusesInByte) * g_statusBits;
+        return static_cast<AccountStatus>((static_cast<uint8_t>(statuses[index / g_statusesInByte]) >> shift) & 3);
+    }
+
+private:
+    MappedFile m_file;
+    size_t m_size;
+};
@@ -0,0 +1,82 @@
+#pragma once
+
+// Helpers shared by the tests and the benchmark of the bank OCR parser.
+// The header replaces the global operator new and delete, so exactly one source file
+// of a program may include it.
+
+#include <atomic>
+#include <cstdlib>
+#include <istream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "BankOcr.h"
+
+// Counts every heap allocation of the program.
+// The replacements are kept out of line, so the compiler does not pair malloc with delete.
+std::atomic<size_t> g_allocationsCount(0);
+
+#ifdef __GNUC__
+#define BANK_OCR_NOINLINE __attribute__((noinline))
+#else
+#define BANK_OCR_NOINLINE
+#endif
+
+BANK_OCR_NOINLINE void* operator new(std::size_t size)
+{
+    ++g_allocationsCount;
+    if (void* memory = std::malloc(size == 0 ? 1 : size))
+    {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+BANK_OCR_NOINLINE void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+BANK_OCR_NOINLINE void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+// Glyph that MakeDisplay draws for '?', it has segments of no digit
+const char g_illegibleGlyphPattern[] = " _ |_| _ ";
+
+// Builds a display from digits, '?' gives an illegible glyph
+inline Display MakeDisplay(const std::string& number)
+{
+    Display display{std::string(g_symbolsInLine, ' '), std::string(g_symbolsInLine, ' '), std::string(g_symbolsInLine, ' ')};
+    for (int i = 0; i < g_digitsOnDisplay; ++i)
+    {
+        const char* pattern = number[i] == '?' ? g_illegibleGlyphPattern : g_glyphPatterns[number[i] - '0'];
+        for (int cell = 0; cell < 9; ++cell)
+        {
+            display.lines[cell / 3][i * 3 + cell % 3] = pattern[cell];
+        }
+    }
+    return display;
+}
+
+// Reads entries of three lines and a separator line with getline, one Display each
+inline std::vector<Display> ReadDisplays(std::istream& input)
+{
+    std::vector<Display> displays;
+    std::string line;
+    while (true)
+    {
+        Display display;
+        if (!std::getline(input, display.lines[0]) ||
+            !std::getline(input, display.lines[1]) ||
+            !std::getline(input, display.lines[2]))
+        {
+            break;
+        }
+        displays.push_back(display);
+        std::getline(input, line);
+    }
+    return displays;
+}
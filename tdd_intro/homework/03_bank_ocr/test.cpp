@@ -87,60 +87,14 @@ Example input and output
 #include <gtest/gtest.h>
 #include <string>
 #include <vector>
-#include <iterator>
+#include <array>
+#include <random>
+#include <fstream>
+#include <cstdio>
 
-const unsigned short g_linesInDigit = 3;
-struct Digit
-{
-    std::string lines[3];
-};
-
-const unsigned short g_digitsOnDisplay = 9;
-struct Display
-{
-    std::string lines[3];
-};
+#include "BankOcr.h"
+#include "BankOcrTestSupport.h"
 
-const Digit s_digit0 = { " _ ",
-                         "| |",
-                         "|_|"
-                       };
-const Digit s_digit1 = { "   ",
-                         "  |",
-                         "  |"
-                       };
-const Digit s_digit2 = { " _ ",
-                         " _|",
-                         "|_ "
-                       };
-const Digit s_digit3 = { " _ ",
-                         " _|",
-                         " _|"
-                       };
-const Digit s_digit4 = { "   ",
-                         "|_|",
-                         "  |"
-                       };
-const Digit s_digit5 = { " _ ",
-                         "|_ ",
-                         " _|"
-                       };
-const Digit s_digit6 = { " _ ",
-                         "|_ ",
-                         "|_|"
-                       };
-const Digit s_digit7 = { " _ ",
-                         "  |",
-                         "  |"
-                       };
-const Digit s_digit8 = { " _ ",
-                         "|_|",
-                         "|_|"
-                       };
-const Digit s_digit9 = { " _ ",
-                         "|_|",
-                         " _|"
-                       };
 const Digit s_noDigit = { " _ ",
                           "|_|",
                           " _ "
@@ -225,85 +179,50 @@ const Display s_wrongDisplay = { " _  _  _  _  _  _  _  _  _ ",
 //   third function, take 1 Digit and return one int.
 // No information about wrong entry*
 
-bool CompareDigits(const Digit& left, const Digit& right)
+TEST(Bank, NumberZero)
 {
-    return left.lines[0] == right.lines[0] && left.lines[1] == right.lines[1] && left.lines[2] == right.lines[2];
+    ASSERT_EQ(0, ZipNumberParser(s_digit0));
 }
 
-int ZipNumberParser(const Digit& digit)
+TEST(Bank, NumberOne)
 {
-    std::vector<Digit> allNumbers;
-    allNumbers.reserve(10);
-    allNumbers.push_back(s_digit0);
-    allNumbers.push_back(s_digit1);
-    allNumbers.push_back(s_digit2);
-    allNumbers.push_back(s_digit3);
-    allNumbers.push_back(s_digit4);
-    allNumbers.push_back(s_digit5);
-    allNumbers.push_back(s_digit6);
-    allNumbers.push_back(s_digit7);
-    allNumbers.push_back(s_digit8);
-    allNumbers.push_back(s_digit9);
-
-    for (int i = 0; i < allNumbers.size(); ++i)
-    {
-        if ( CompareDigits(digit, allNumbers[i]) )
-        {
-            return i;
-        }
-    }
-    return -1;
+    ASSERT_EQ(1, ZipNumberParser(s_digit1));
 }
 
-std::string ZipLineParser(const Display& display)
+TEST(Bank, NumberThree)
 {
-    if (display.lines[0].size() != 27 || display.lines[1].size() != 27 || display.lines[2].size() != 27)
-    {
-        return "-1";
-    }
-    std::string answer="";
-    for(int i = 0; i < 27; i+=3)
-    {
-        Digit tempDigit{ std::string(display.lines[0].begin() + i,display.lines[0].begin()+3 + i),
-                         std::string(display.lines[1].begin() + i,display.lines[1].begin()+3 + i),
-                         std::string(display.lines[2].begin() + i,display.lines[2].begin()+3 + i)};
-        int temp = ZipNumberParser(tempDigit);
-        if(temp == -1)
-        {
-            return "-1";
-        }
-        else
-        {
-            answer = answer + std::to_string(temp);
-        }
-    }
-    return answer;
+    ASSERT_EQ(3, ZipNumberParser(s_digit3));
 }
 
-std::vector<std::string> ZipVectorParser(std::vector<Display> displays)
+TEST(Bank, AllNumbers)
 {
-    std::vector<std::string> answer;
-    for(auto disp:displays)
+    const Digit* allNumbers[] = {&s_digit0, &s_digit1, &s_digit2, &s_digit3, &s_digit4,
+                                 &s_digit5, &s_digit6, &s_digit7, &s_digit8, &s_digit9};
+    for (int i = 0; i < 10; ++i)
     {
-        answer.push_back(ZipLineParser(disp));
+        EXPECT_EQ(i, ZipNumberParser(*allNumbers[i]));
     }
-    return answer;
 }
 
-
-TEST(Bank, NumberZero)
-{
-    ASSERT_EQ(0, ZipNumberParser(s_digit0));
-}
-
-TEST(Bank, NumberOne)
+TEST(Bank, StraySymbolInDigit)
 {
-    ASSERT_EQ(1, ZipNumberParser(s_digit1));
+    const Digit pipeInsteadOfUnderscore{" | ", "| |", "|_|"};
+    ASSERT_EQ(-1, ZipNumberParser(pipeInsteadOfUnderscore));
 }
 
-TEST(Bank, NumberThree)
+TEST(Bank, TableDecoderSameAsScan)
 {
-    ASSERT_EQ(3, ZipNumberParser(s_digit3));
+    const char symbols[] = {' ', '_', '|'};
+    for (int combination = 0; combination < 19683; ++combination) // 3^9 glyphs
+    {
+        Digit digit{std::string(3, ' '), std::string(3, ' '), std::string(3, ' ')};
+        int rest = combination;
+        for (int cell = 0; cell < 9; ++cell, rest /= 3)
+        {
+            digit.lines[cell / 3][cell % 3] = symbols[rest % 3];
+        }
+        ASSERT_EQ(ZipNumberParserByScan(digit), ZipNumberParser(digit)) << combination;
+    }
 }
 
 TEST(Bank, WrongNumber)
@@ -355,6 +274,54 @@ TEST(Bank, WrongDispley)
     ASSERT_EQ("-1", ZipLineParser(s_wrongDisplay));
 }
 
+TEST(Bank, LineToArray)
+{
+    std::array<char, 9> answer;
+    ASSERT_TRUE(ZipLineParser(s_display123456789, answer));
+    ASSERT_EQ("123456789", std::string(answer.begin(), answer.end()));
+}
+
+TEST(Bank, LineToCharArray)
+{
+    char answer[9];
+    ASSERT_TRUE(ZipLineParser(s_displayAll2, answer));
+    ASSERT_EQ("222222222", std::string(answer, 9));
+}
+
+TEST(Bank, WrongLineToArray)
+{
+    std::array<char, 9> answer;
+    Display emptyDisplay{"", "", ""};
+    ASSERT_FALSE(ZipLineParser(s_wrongDisplay, answer));
+    ASSERT_FALSE(ZipLineParser(emptyDisplay, answer));
+}
+
+TEST(Bank, CountingAllocatorSeesAllocations)
+{
+    const size_t before = g_allocationsCount;
+    std::vector<char> heapBuffer(100);
+    ASSERT_EQ(before + 1, g_allocationsCount.load());
+}
+
+TEST(Bank, LineToArrayDoesNotAllocate)
+{
+    const Display* displays[] = {&s_displayAll0, &s_displayAll8, &s_display123456789, &s_wrongDisplay};
+    std::array<char, 9> answer;
+    char charAnswer[9];
+    size_t parsed = 0;
+
+    const size_t before = g_allocationsCount;
+    for (int i = 0; i < 1000; ++i)
+    {
+        parsed += ZipLineParser(*displays[i % 4], answer);
+        parsed += ZipLineParser(*displays[i % 4], charAnswer);
+    }
+    const size_t allocations = g_allocationsCount - before;
+
+    ASSERT_EQ(1500u, parsed);
+    ASSERT_EQ(0u, allocations);
+}
+
 TEST(Bank, TwoLines)
 {
     std::vector<Display> linesOfDisplay;
@@ -392,3 +359,528 @@ TEST(Bank, ThreeLinesWithWrongDisplay)
     ASSERT_EQ(answer, ZipVectorParser(linesOfDisplay));
 }
 
+
+std::string ToScanText(const Display& display)
+{
+    return display.lines[0] + "\n" + display.lines[1] + "\n" + display.lines[2] + "\n\n";
+}
+
+std::vector<std::string> CollectStream(const std::string& scan)
+{
+    std::vector<std::string> accounts;
+    ZipStreamParser(scan.data(), scan.size(), [&accounts](const std::string& account)
+    {
+        accounts.push_back(account);
+    });
+    return accounts;
+}
+
+TEST(BankStream, EmptyScan)
+{
+    ASSERT_EQ(std::vector<std::string>(), CollectStream(""));
+}
+
+TEST(BankStream, OneEntry)
+{
+    ASSERT_EQ(std::vector<std::string>{"123456789"}, CollectStream(ToScanText(s_display123456789)));
+}
+
+TEST(BankStream, LastEntryWithoutSeparator)
+{
+    std::string scan = ToScanText(s_displayAll0) + s_displayAll1.lines[0] + "\n" +
+                       s_displayAll1.lines[1] + "\n" + s_displayAll1.lines[2];
+    std::vector<std::string> answer{"000000000", "111111111"};
+    ASSERT_EQ(answer, CollectStream(scan));
+}
+
+TEST(BankStream, WindowsLineEndings)
+{
+    std::string scan = s_displayAll2.lines[0] + "\r\n" + s_displayAll2.lines[1] + "\r\n" +
+                       s_displayAll2.lines[2] + "\r\n\r\n";
+    ASSERT_EQ(std::vector<std::string>{"222222222"}, CollectStream(scan));
+}
+
+TEST(BankStream, WrongEntries)
+{
+    std::string scan = ToScanText(s_displayAll0) + ToScanText(s_wrongDisplay) +
+                       "short\nshort\nshort\n\n" + ToScanText(s_display123456789);
+    std::vector<std::string> answer{"000000000", "-1", "-1", "123456789"};
+    ASSERT_EQ(answer, CollectStream(scan));
+}
+
+TEST(BankStream, TruncatedEntry)
+{
+    std::string scan = ToScanText(s_displayAll0) + s_displayAll1.lines[0] + "\n";
+    std::vector<std::string> answer{"000000000", "-1"};
+    ASSERT_EQ(answer, CollectStream(scan));
+}
+
+TEST(BankStream, TrailingEmptyLines)
+{
+    const std::string rows = s_displayAll0.lines[0] + "\n" + s_displayAll0.lines[1] + "\n" + s_displayAll0.lines[2];
+    for (size_t newlines = 1; newlines <= 6; ++newlines)
+    {
+        ASSERT_EQ(std::vector<std::string>{"000000000"}, CollectStream(rows + std::string(newlines, '\n'))) << newlines;
+    }
+    ASSERT_EQ(std::vector<std::string>{"000000000"}, CollectStream(ToScanText(s_displayAll0) + "\r\n\r\n\r\n\r\n"));
+}
+
+TEST(BankStream, EmptyLinesBetweenEntries)
+{
+    const std::string scan = ToScanText(s_displayAll0) + "\n\n\n\n" + ToScanText(s_display123456789);
+    std::vector<std::string> answer{"000000000", "123456789"};
+    ASSERT_EQ(answer, CollectStream(scan));
+}
+
+TEST(BankStream, SameAsVectorParser)
+{
+    std::vector<Display> displays{s_displayAll0, s_displayAll3, s_wrongDisplay, s_displayAll9, s_display123456789};
+    std::string scan;
+    for (const Display& display : displays)
+    {
+        scan += ToScanText(display);
+    }
+    ASSERT_EQ(ZipVectorParser(displays), CollectStream(scan));
+}
+
+TEST(BankStream, ParseFile)
+{
+    const std::string path = "bank_ocr_stream_test.txt";
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << ToScanText(s_displayAll4) << ToScanText(s_display123456789);
+    }
+    std::vector<std::string> accounts;
+    size_t entries = ZipFileParser(path, [&accounts](const std::string& account)
+    {
+        accounts.push_back(account);
+    });
+    std::remove(path.c_str());
+
+    std::vector<std::string> answer{"444444444", "123456789"};
+    ASSERT_EQ(2u, entries);
+    ASSERT_EQ(answer, accounts);
+}
+
+TEST(BankStream, FileWithTrailingNewlines)
+{
+    const std::string path = "bank_ocr_stream_test.txt";
+    const std::string rows = s_displayAll0.lines[0] + "\n" + s_displayAll0.lines[1] + "\n" + s_displayAll0.lines[2];
+    for (size_t newlines = 1; newlines <= 6; ++newlines)
+    {
+        {
+            std::ofstream file(path, std::ios::binary | std::ios::trunc);
+            file << rows << std::string(newlines, '\n');
+        }
+        std::vector<std::string> accounts;
+        ZipFileParser(path, [&accounts](const std::string& account)
+        {
+            accounts.push_back(account);
+        });
+        EXPECT_EQ(std::vector<std::string>{"000000000"}, accounts) << newlines;
+    }
+    std::remove(path.c_str());
+}
+
+TEST(BankStream, MissingFile)
+{
+    ASSERT_THROW(ZipFileParser("no_such_scan_file.txt", [](const std::string&){}), std::runtime_error);
+}
+
+Display RandomDisplay(std::mt19937& random)
+{
+    const char symbols[] = {' ', '_', '|', 'x'};
+    Display display{std::string(27, ' '), std::string(27, ' '), std::string(27, ' ')};
+    for (int i = 0; i < g_digitsOnDisplay; ++i)
+    {
+        const bool legible = random() % 4 != 0;
+        const int digit = random() % 10;
+        for (int cell = 0; cell < 9; ++cell)
+        {
+            const char symbol = legible ? g_glyphPatterns[digit][cell] : symbols[random() % 4];
+            display.lines[cell / 3][i * 3 + cell % 3] = symbol;
+        }
+    }
+    return display;
+}
+
+TEST(BankBatch, LineOfEachNumber)
+{
+    const Display* displays[] = {&s_displayAll0, &s_displayAll1, &s_displayAll2, &s_displayAll3, &s_displayAll4,
+                                 &s_displayAll5, &s_displayAll6, &s_displayAll7, &s_displayAll8, &s_displayAll9};
+    for (int i = 0; i < 10; ++i)
+    {
+        EXPECT_EQ(std::string(9, static_cast<char>('0' + i)), ZipBatchLineParser(*displays[i]));
+    }
+}
+
+TEST(BankBatch, WrongDisplays)
+{
+    Display emptyDisplay{"", "", ""};
+    ASSERT_EQ("-1", ZipBatchLineParser(emptyDisplay));
+    ASSERT_EQ("-1", ZipBatchLineParser(s_wrongDisplay));
+}
+
+TEST(BankBatch, StrayTopPipe)
+{
+    Display display = s_display123456789;
+    display.lines[0][0] = '|';
+    ASSERT_EQ("-1", ZipBatchLineParser(display));
+}
+
+TEST(BankBatch, RandomizedSameAsLineParser)
+{
+    std::mt19937 random(20181018);
+    for (int i = 0; i < 20000; ++i)
+    {
+        const Display display = RandomDisplay(random);
+        ASSERT_EQ(ZipLineParser(display), ZipBatchLineParser(display)) << display.lines[0] << "\n"
+                                                                       << display.lines[1] << "\n"
+                                                                       << display.lines[2];
+    }
+}
+
+#ifdef BANK_OCR_AVX2
+TEST(BankBatch, RandomizedAvx2SameAsScalar)
+{
+    if (!HasAvx2())
+    {
+        return;
+    }
+    std::mt19937 random(27);
+    for (int i = 0; i < 20000; ++i)
+    {
+        const Display display = RandomDisplay(random);
+        int scalarDigits[g_digitsOnDisplay];
+        int vectorDigits[g_digitsOnDisplay];
+        ZipRowsDecoderScalar(display.lines[0].data(), display.lines[1].data(), display.lines[2].data(), scalarDigits);
+        ZipRowsDecoderAvx2(display.lines[0].data(), display.lines[1].data(), display.lines[2].data(), vectorDigits);
+        ASSERT_TRUE(std::equal(scalarDigits, scalarDigits + g_digitsOnDisplay, vectorDigits));
+    }
+}
+#endif
+
+std::vector<Display> RandomDisplays(size_t count, unsigned seed)
+{
+    std::mt19937 random(seed);
+    std::vector<Display> displays;
+    displays.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        displays.push_back(RandomDisplay(random));
+    }
+    return displays;
+}
+
+TEST(BankParallel, Empty)
+{
+    ASSERT_EQ(std::vector<std::string>(), ZipParallelVectorParser(std::vector<Display>(), 4));
+}
+
+TEST(BankParallel, KeepsOrder)
+{
+    // every entry holds its own index, so any swap between or inside chunks shows up
+    std::vector<Display> displays;
+    std::vector<std::string> answer;
+    for (size_t entry = 0; entry < g_entriesInChunk * 4 + 17; ++entry)
+    {
+        const std::string digits = std::to_string(entry);
+        answer.push_back(std::string(g_digitsOnDisplay - digits.size(), '0') + digits);
+        displays.push_back(MakeDisplay(answer.back()));
+    }
+    ASSERT_EQ(answer, ZipParallelVectorParser(displays, 4));
+}
+
+TEST(BankParallel, SameAsVectorParser)
+{
+    const std::vector<Display> displays = RandomDisplays(g_entriesInChunk * 5 + 17, 4);
+    const std::vector<std::string> answer = ZipVectorParser(displays);
+    for (unsigned threads : {1u, 2u, 3u, 8u, 0u})
+    {
+        ASSERT_EQ(answer, ZipParallelVectorParser(displays, threads)) << threads;
+    }
+}
+
+TEST(BankAccount, ValidChecksum)
+{
+    const AccountResult result = ZipAccountParser(MakeDisplay("457508000"));
+    std::array<int, 9> digits{{4, 5, 7, 5, 0, 8, 0, 0, 0}};
+    ASSERT_EQ(digits, result.digits);
+    ASSERT_TRUE(result.checksumValid);
+    ASSERT_EQ(AccountStatus::Ok, result.status);
+    ASSERT_EQ("457508000", ToString(result));
+}
+
+TEST(BankAccount, WrongChecksum)
+{
+    const AccountResult result = ZipAccountParser(MakeDisplay("664371495"));
+    ASSERT_FALSE(result.checksumValid);
+    ASSERT_EQ(AccountStatus::Error, result.status);
+    ASSERT_EQ("664371495 ERR", ToString(result));
+}
+
+TEST(BankAccount, IllegibleDigits)
+{
+    const AccountResult result = ZipAccountParser(MakeDisplay("86110??36"));
+    ASSERT_EQ(-1, result.digits[5]);
+    ASSERT_FALSE(result.checksumValid);
+    ASSERT_EQ(AccountStatus::Illegible, result.status);
+    ASSERT_EQ("86110??36 ILL", ToString(result));
+}
+
+TEST(BankAccount, WrongWidth)
+{
+    Display emptyDisplay{"", "", ""};
+    const AccountResult result = ZipAccountParser(emptyDisplay);
+    ASSERT_EQ(AccountStatus::Illegible, result.status);
+    ASSERT_EQ("????????? ILL", ToString(result));
+}
+
+TEST(BankAccount, SameDigitsAsLineParser)
+{
+    const std::vector<Display> displays = RandomDisplays(5000, 11);
+    const std::vector<AccountResult> results = ZipVectorAccountParser(displays);
+    for (size_t i = 0; i < displays.size(); ++i)
+    {
+        const std::string number = ToString(results[i]).substr(0, 9);
+        const std::string expected = ZipLineParser(displays[i]);
+        ASSERT_EQ(expected == "-1", results[i].status == AccountStatus::Illegible);
+        if (expected != "-1")
+        {
+            ASSERT_EQ(expected, number);
+        }
+    }
+}
+
+TEST(BankCorrection, ValidAccountUnchanged)
+{
+    ASSERT_EQ("123456789", ToString(ZipAccountCorrector(s_display123456789)));
+}
+
+TEST(BankCorrection, SingleFix)
+{
+    ASSERT_EQ("711111111", ToString(ZipAccountCorrector(s_displayAll1)));
+    ASSERT_EQ("777777177", ToString(ZipAccountCorrector(s_displayAll7)));
+    ASSERT_EQ("200800000", ToString(ZipAccountCorrector(MakeDisplay("200000000"))));
+    ASSERT_EQ("333393333", ToString(ZipAccountCorrector(s_displayAll3)));
+}
+
+TEST(BankCorrection, Ambiguous)
+{
+    ASSERT_EQ("888888888 AMB ['888886888', '888888880', '888888988']", ToString(ZipAccountCorrector(s_displayAll8)));
+    ASSERT_EQ("555555555 AMB ['555655555', '559555555']", ToString(ZipAccountCorrector(s_displayAll5)));
+    ASSERT_EQ("666666666 AMB ['666566666', '686666666']", ToString(ZipAccountCorrector(s_displayAll6)));
+    ASSERT_EQ("999999999 AMB ['899999999', '993999999', '999959999']", ToString(ZipAccountCorrector(s_displayAll9)));
+    ASSERT_EQ("490067715 AMB ['490067115', '490067719', '490867715']",
+              ToString(ZipAccountCorrector(MakeDisplay("490067715"))));
+}
+
+TEST(BankCorrection, IllegibleDigitFixed)
+{
+    const Display missingSegment = { " _     _  _  _  _  _  _    ",
+                                     "| || || || || || || ||_   |",
+                                     "|_||_||_||_||_||_||_| _|  |" };
+    ASSERT_EQ("000000051", ToString(ZipAccountCorrector(missingSegment)));
+
+    const Display missingSegmentInLastDigit = { "    _  _  _  _  _  _     _ ",
+                                   "|_||_|| ||_||_   |  |  | _ ",
+                                   "  | _||_||_||_|  |  |  | _|" };
+    ASSERT_EQ("490867715", ToString(ZipAccountCorrector(missingSegmentInLastDigit)));
+
+    const Display straySymbol = { "    _  _     _  _  _  _  _ ",
+                                  "  | _| _||_| _ |_   ||_||_|",
+                                  "  ||_  _|  | _||_|  ||_| _|" };
+    ASSERT_EQ("123456789", ToString(ZipAccountCorrector(straySymbol)));
+}
+
+TEST(BankCorrection, GlyphTwoChangesAwayStaysIllegible)
+{
+    const Display twoStraySymbols = { "    _  _    |_| _  _  _  _ ",
+                                      "  | _| _||_||_ |_   ||_||_|",
+                                      "  ||_  _|  | _||_|  ||_| _|" };
+    const CorrectedAccount stray = ZipAccountCorrector(twoStraySymbols);
+    ASSERT_EQ("1234?6789 ILL", ToString(stray));
+    ASSERT_TRUE(stray.alternatives.empty());
+
+    const Display strayAndMissingSegment = { "    _  _    |   _  _  _  _ ",
+                                             "  | _| _||_||_ |_   ||_||_|",
+                                             "  ||_  _|  | _||_|  ||_| _|" };
+    const CorrectedAccount strayAndMissing = ZipAccountCorrector(strayAndMissingSegment);
+    ASSERT_EQ("1234?6789 ILL", ToString(strayAndMissing));
+    ASSERT_TRUE(strayAndMissing.alternatives.empty());
+}
+
+TEST(BankCorrection, SeveralIllegibleDigitsStayIllegible)
+{
+    ASSERT_EQ("86110??36 ILL", ToString(ZipAccountCorrector(MakeDisplay("86110??36"))));
+}
+
+TEST(BankCorrection, WrongWidthStaysIllegible)
+{
+    Display emptyDisplay{"", "", ""};
+    ASSERT_EQ("????????? ILL", ToString(ZipAccountCorrector(emptyDisplay)));
+}
+
+std::vector<std::string> CollectIncremental(const std::string& scan, std::mt19937& random, size_t maxChunk)
+{
+    std::vector<std::string> accounts;
+    ZipIncrementalParser parser([&accounts](const std::string& account)
+    {
+        accounts.push_back(account);
+    });
+    for (size_t position = 0; position < scan.size();)
+    {
+        const size_t chunk = std::min(scan.size() - position, 1 + random() % maxChunk);
+        parser.Feed(scan.data() + position, chunk);
+        position += chunk;
+    }
+    parser.Finish();
+    return accounts;
+}
+
+TEST(BankIncremental, EmptyScan)
+{
+    std::mt19937 random(1);
+    ASSERT_EQ(std::vector<std::string>(), CollectIncremental("", random, 10));
+}
+
+TEST(BankIncremental, ByteByByte)
+{
+    std::mt19937 random(1);
+    std::string scan = ToScanText(s_display123456789) + ToScanText(s_wrongDisplay);
+    std::vector<std::string> answer{"123456789", "-1"};
+    ASSERT_EQ(answer, CollectIncremental(scan, random, 1));
+}
+
+TEST(BankIncremental, EmitsOnSeparator)
+{
+    std::vector<std::string> accounts;
+    ZipIncrementalParser parser([&accounts](const std::string& account)
+    {
+        accounts.push_back(account);
+    });
+    const std::string scan = ToScanText(s_displayAll7);
+    parser.Feed(scan.data(), scan.size() - 1);
+    ASSERT_TRUE(accounts.empty());
+    parser.Feed("\n", 1);
+    ASSERT_EQ(std::vector<std::string>{"777777777"}, accounts);
+    ASSERT_EQ(1u, parser.Entries());
+}
+
+TEST(BankIncremental, FinishWithoutSeparator)
+{
+    std::mt19937 random(1);
+    std::string scan = ToScanText(s_displayAll0) + s_displayAll1.lines[0] + "\n" +
+                       s_displayAll1.lines[1] + "\n" + s_displayAll1.lines[2];
+    std::vector<std::string> answer{"000000000", "111111111"};
+    ASSERT_EQ(answer, CollectIncremental(scan, random, 7));
+}
+
+TEST(BankIncremental, LongLine)
+{
+    std::mt19937 random(1);
+    std::string scan = s_displayAll0.lines[0] + " \n" + s_displayAll0.lines[1] + "\n" +
+                       s_displayAll0.lines[2] + "\n\n" + ToScanText(s_displayAll3);
+    std::vector<std::string> answer{"-1", "333333333"};
+    ASSERT_EQ(answer, CollectIncremental(scan, random, 5));
+}
+
+TEST(BankIncremental, RandomChunksSameAsStream)
+{
+    std::mt19937 random(9);
+    std::string scan;
+    for (const Display& display : RandomDisplays(500, 10))
+    {
+        const bool windows = random() % 2 == 0;
+        for (const std::string& line : display.lines)
+        {
+            scan += line + (windows ? "\r\n" : "\n");
+        }
+        scan += random() % 5 == 0 ? "short\n" : "\n";
+    }
+    scan += "truncated\n";
+    ASSERT_EQ(CollectStream(scan), CollectIncremental(scan, random, 100));
+
+}
+
+TEST(BankIncremental, TrailingNewlines)
+{
+    std::mt19937 random(11);
+    const std::string rows = s_displayAll0.lines[0] + "\n" + s_displayAll0.lines[1] + "\n" + s_displayAll0.lines[2];
+    for (size_t newlines = 1; newlines <= 6; ++newlines)
+    {
+        const std::string scan = rows + std::string(newlines, '\n');
+        ASSERT_EQ(std::vector<std::string>{"000000000"}, CollectIncremental(scan, random, 3)) << newlines;
+    }
+    ASSERT_EQ(std::vector<std::string>{"000000000"}, CollectIncremental(ToScanText(s_displayAll0) + "\r\n\n\r\n", random, 3));
+}
+
+TEST(BankBinary, PackedAccounts)
+{
+    std::vector<Display> displays{MakeDisplay("457508000"), MakeDisplay("664371495"),
+                                  MakeDisplay("86110??36"), s_displayAll0, s_display123456789};
+    const AccountBatch batch = ZipBatchAccountParser(displays);
+
+    std::vector<uint32_t> accounts{457508000, 664371495, 861100036, 0, 123456789};
+    ASSERT_EQ(accounts, batch.accounts);
+    ASSERT_EQ(2u, batch.statuses.size());
+    ASSERT_EQ(AccountStatus::Ok, batch.Status(0));
+    ASSERT_EQ(AccountStatus::Error, batch.Status(1));
+    ASSERT_EQ(AccountStatus::Illegible, batch.Status(2));
+    ASSERT_EQ(AccountStatus::Ok, batch.Status(3));
+    ASSERT_EQ(AccountStatus::Ok, batch.Status(4));
+}
+
+TEST(BankBinary, WriteAndMapBack)
+{
+    const std::string path = "bank_ocr_batch_test.bin";
+    const std::vector<Display> displays = RandomDisplays(1001, 8);
+    const AccountBatch batch = ZipBatchAccountParser(displays);
+    WriteAccountBatch(batch, path);
+    {
+        AccountBatchView view(path);
+        ASSERT_EQ(batch.Size(), view.Size());
+        for (size_t i = 0; i < view.Size(); ++i)
+        {
+            ASSERT_EQ(batch.accounts[i], view.Account(i));
+            ASSERT_EQ(batch.Status(i), view.Status(i));
+        }
+    }
+    std::remove(path.c_str());
+}
+
+TEST(BankBinary, EmptyBatch)
+{
+    const std::string path = "bank_ocr_empty_batch_test.bin";
+    WriteAccountBatch(AccountBatch(), path);
+    {
+        AccountBatchView view(path);
+        ASSERT_EQ(0u, view.Size());
+    }
+    std::remove(path.c_str());
+}
+
+TEST(BankBinary, NotABatchFile)
+{
+    const std::string path = "bank_ocr_not_batch_test.bin";
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << ToScanText(s_displayAll0);
+    }
+    ASSERT_THROW(AccountBatchView view(path), std::runtime_error);
+    std::remove(path.c_str());
+}
+
+TEST(BankBinary, TruncatedBatchFile)
+{
+    const std::string path = "bank_ocr_truncated_batch_test.bin";
+    WriteAccountBatch(ZipBatchAccountParser(RandomDisplays(10, 3)), path);
+    {
+        MappedFile file(path);
+        std::ofstream truncated(path + ".cut", std::ios::binary);
+        truncated.write(file.Data(), file.Size() - 1);
+    }
+    ASSERT_THROW(AccountBatchView view(path + ".cut"), std::runtime_error);
+    std::remove(path.c_str());
+    std::remove((path + ".cut").c_str());
+}
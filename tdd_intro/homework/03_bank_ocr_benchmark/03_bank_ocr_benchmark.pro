@@ -0,0 +1,13 @@
+TEMPLATE = app
+CONFIG += console c++17 thread release
+CONFIG -= app_bundle
+CONFIG -= qt
+
+INCLUDEPATH += ../03_bank_ocr
+
+SOURCES += \
+    benchmark.cpp
+
+HEADERS += \
+    ../03_bank_ocr/BankOcr.h \
+    ../03_bank_ocr/BankOcrTestSupport.h
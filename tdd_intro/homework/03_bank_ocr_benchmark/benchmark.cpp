@@ -0,0 +1,331 @@
+/*
+Benchmark suite for the bank OCR parser.
+
+Usage: 03_bank_ocr_benchmark [max power of ten, default 7]
+
+Every corpus is generated with 10^3 ... 10^N entries:
+  valid         - account numbers passing the checksum
+  mixed-invalid - valid accounts where 5% of glyphs lose or get one segment
+  wrong-widths  - valid accounts where 10% of entries have a line one symbol shorter or longer
+
+Every parser is reported with ns/entry, heap allocations per entry and the peak RSS of the
+process. The peak is never reset, so a row shows the largest footprint of every run up to
+and including it, not of its own parser.
+The largest corpus of 10^7 entries needs about 3 GB of memory for its Display objects.
+*/
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+#include "BankOcr.h"
+#include "BankOcrTestSupport.h"
+
+enum class CorpusKind
+{
+    Valid,
+    MixedInvalid,
+    WrongWidths
+};
+
+const char* CorpusName(CorpusKind kind)
+{
+    switch (kind)
+    {
+    case CorpusKind::Valid:
+        return "valid";
+    case CorpusKind::MixedInvalid:
+        return "mixed-invalid";
+    default:
+        return "wrong-widths";
+    }
+}
+
+std::string RandomValidNumber(std::mt19937& random)
+{
+    while (true)
+    {
+        std::string number(g_digitsOnDisplay, '0');
+        int checksum = 0;
+        for (int i = 0; i < g_digitsOnDisplay - 1; ++i)
+        {
+            number[i] = static_cast<char>('0' + random() % 10);
+            checksum += (number[i] - '0') * (g_digitsOnDisplay - i);
+        }
+        const int lastDigit = (11 - checksum % 11) % 11;
+        if (lastDigit != 10)
+        {
+            number[g_digitsOnDisplay - 1] = static_cast<char>('0' + lastDigit);
+            return number;
+        }
+    }
+}
+
+std::vector<Display> MakeCorpus(CorpusKind kind, size_t count)
+{
+    std::mt19937 random(static_cast<unsigned>(count) + static_cast<unsigned>(kind));
+    std::vector<Display> displays;
+    displays.reserve(count);
+    for (size_t entry = 0; entry < count; ++entry)
+    {
+        Display display = MakeDisplay(RandomValidNumber(random));
+        if (kind == CorpusKind::MixedInvalid)
+        {
+            for (int i = 0; i < g_digitsOnDisplay; ++i)
+            {
+                if (random() % 100 < 5)
+                {
+                    const int cell = random() % 9;
+                    char& symbol = display.lines[cell / 3][i * 3 + cell % 3];
+                    symbol = symbol == ' ' ? g_segmentSymbols[cell] : ' ';
+                }
+            }
+        }
+        else if (kind == CorpusKind::WrongWidths && random() % 10 == 0)
+        {
+            std::string& line = display.lines[random() % g_linesInDigit];
+            random() % 2 == 0 ? line.pop_back() : line.push_back(' ');
+        }
+        displays.push_back(std::move(display));
+    }
+    return displays;
+}
+
+std::string ToScanText(const std::vector<Display>& displays)
+{
+    std::string scan;
+    scan.reserve(displays.size() * (g_linesInDigit * (g_symbolsInLine + 1) + 1));
+    for (const Display& display : displays)
+    {
+        for (const std::string& line : display.lines)
+        {
+            scan += line;
+            scan += '\n';
+        }
+        scan += '\n';
+    }
+    return scan;
+}
+
+// High-water mark of the whole process since it started
+double ProcessPeakRssMegabytes()
+{
+#ifndef _WIN32
+    rusage usage;
+    if (::getrusage(RUSAGE_SELF, &usage) == 0)
+    {
+        return usage.ru_maxrss / 1024.0; // kilobytes on Linux
+    }
+#endif
+    return 0;
+}
+
+// Runs the function once and prints one row of the report.
+// The function returns a value depending on its results, so nothing is optimized away.
+template <typename Function>
+void Measure(const char* parser, const char* corpus, size_t entries, Function function)
+{
+    const size_t allocationsBefore = g_allocationsCount;
+    const auto start = std::chrono::steady_clock::now();
+    const size_t result = function();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const size_t allocations = g_allocationsCount - allocationsBefore;
+
+    std::cout << std::left << std::setw(28) << parser << std::setw(15) << corpus
+              << std::right << std::setw(10) << entries
+              << std::fixed << std::setprecision(1) << std::setw(12) << seconds * 1e9 / entries
+              << std::setprecision(2) << std::setw(14) << static_cast<double>(allocations) / entries
+              << std::setprecision(1) << std::setw(20) << ProcessPeakRssMegabytes()
+              << std::setw(12) << result << std::endl;
+}
+
+void RunCorpus(CorpusKind kind, size_t entries)
+{
+    const char* corpus = CorpusName(kind);
+    const std::vector<Display> displays = MakeCorpus(kind, entries);
+    const std::string scan = ToScanText(displays);
+
+    // Digits are taken from a window of the corpus, so they stay small for large corpora
+    std::vector<Digit> digits;
+    const size_t digitEntries = std::min<size_t>(entries, 10000);
+    for (size_t entry = 0; entry < digitEntries; ++entry)
+    {
+        for (int i = 0; i < g_digitsOnDisplay; ++i)
+        {
+            const Display& display = displays[entry];
+            Digit digit;
+            for (int row = 0; row < g_linesInDigit; ++row)
+            {
+                digit.lines[row] = display.lines[row].substr(std::min<size_t>(i * 3, display.lines[row].size()), 3);
+            }
+            digits.push_back(digit);
+        }
+    }
+
+    Measure("ZipNumberParserByScan", corpus, entries, [&]()
+    {
+        size_t legible = 0;
+        for (size_t i = 0; i < entries * g_digitsOnDisplay; ++i)
+        {
+            legible += ZipNumberParserByScan(digits[i % digits.size()]) >= 0;
+        }
+        return legible;
+    });
+    Measure("ZipNumberParser", corpus, entries, [&]()
+    {
+        size_t legible = 0;
+        for (size_t i = 0; i < entries * g_digitsOnDisplay; ++i)
+        {
+            legible += ZipNumberParser(digits[i % digits.size()]) >= 0;
+        }
+        return legible;
+    });
+    Measure("ZipLineParser", corpus, entries, [&]()
+    {
+        size_t legible = 0;
+        for (const Display& display : displays)
+        {
+            legible += ZipLineParser(display) != "-1";
+        }
+        return legible;
+    });
+    Measure("ZipLineParser(array)", corpus, entries, [&]()
+    {
+        size_t legible = 0;
+        std::array<char, g_digitsOnDisplay> answer;
+        for (const Display& display : displays)
+        {
+            legible += ZipLineParser(display, answer);
+        }
+        return legible;
+    });
+    Measure("ZipVectorParser", corpus, entries, [&]()
+    {
+        return ZipVectorParser(displays).size();
+    });
+    Measure("ZipParallelVectorParser", corpus, entries, [&]()
+    {
+        return ZipParallelVectorParser(displays).size();
+    });
+    Measure("ZipAccountParser", corpus, entries, [&]()
+    {
+        size_t valid = 0;
+        for (const Display& display : displays)
+        {
+            valid += ZipAccountParser(display).status == AccountStatus::Ok;
+        }
+        return valid;
+    });
+    Measure("ZipAccountCorrector", corpus, entries, [&]()
+    {
+        size_t valid = 0;
+        for (const Display& display : displays)
+        {
+            valid += ZipAccountCorrector(display).account.status == AccountStatus::Ok;
+        }
+        return valid;
+    });
+    Measure("ZipBatchAccountParser", corpus, entries, [&]()
+    {
+        return ZipBatchAccountParser(displays).Size();
+    });
+    Measure("ZipStreamParser", corpus, entries, [&]()
+    {
+        size_t legible = 0;
+        ZipStreamParser(scan.data(), scan.size(), [&legible](const std::string& account)
+        {
+            legible += account != "-1";
+        });
+        return legible;
+    });
+    Measure("ZipIncrementalParser", corpus, entries, [&]()
+    {
+        size_t legible = 0;
+        ZipIncrementalParser parser([&legible](const std::string& account)
+        {
+            legible += account != "-1";
+        });
+        const size_t chunk = 64 * 1024;
+        for (size_t position = 0; position < scan.size(); position += chunk)
+        {
+            parser.Feed(scan.data() + position, std::min(chunk, scan.size() - position));
+        }
+        parser.Finish();
+        return legible;
+    });
+
+    const std::string path = "bank_ocr_benchmark_scan.txt";
+    {
+        std::ofstream file(path, std::ios::binary);
+        file.write(scan.data(), scan.size());
+    }
+    Measure("file: getline+vector", corpus, entries, [&]()
+    {
+        std::ifstream input(path, std::ios::binary);
+        return ZipVectorParser(ReadDisplays(input)).size();
+    });
+    Measure("file: ZipFileParser", corpus, entries, [&]()
+    {
+        size_t legible = 0;
+        ZipFileParser(path, [&legible](const std::string& account)
+        {
+            legible += account != "-1";
+        });
+        return legible;
+    });
+    std::remove(path.c_str());
+}
+
+void RunParallelScaling(size_t entries)
+{
+    const std::vector<Display> displays = MakeCorpus(CorpusKind::Valid, entries);
+    const unsigned maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    double singleSeconds = 0;
+    std::cout << "\nZipParallelVectorParser scaling, " << entries << " entries" << std::endl;
+    for (unsigned threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        const std::vector<std::string> answer = ZipParallelVectorParser(displays, threads);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        singleSeconds = threads == 1 ? seconds : singleSeconds;
+        std::cout << std::setw(4) << threads << " threads: " << std::fixed << std::setprecision(0)
+                  << answer.size() / seconds << " entries/s, speedup " << std::setprecision(2)
+                  << singleSeconds / seconds << std::endl;
+        if (threads < maxThreads && threads * 2 > maxThreads)
+        {
+            threads = maxThreads / 2; // always measure all cores
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const int maxPower = argc > 1 ? std::atoi(argv[1]) : 7;
+    if (maxPower < 3)
+    {
+        std::cerr << "Usage: " << argv[0] << " [max power of ten, at least 3]" << std::endl;
+        return 1;
+    }
+
+    std::cout << std::left << std::setw(28) << "parser" << std::setw(15) << "corpus"
+              << std::right << std::setw(10) << "entries" << std::setw(12) << "ns/entry"
+              << std::setw(14) << "allocs/entry" << std::setw(20) << "process peak RSS MB"
+              << std::setw(12) << "result" << std::endl;
+    size_t entries = 1000;
+    for (int power = 3; power <= maxPower; ++power, entries *= 10)
+    {
+        for (CorpusKind kind : {CorpusKind::Valid, CorpusKind::MixedInvalid, CorpusKind::WrongWidths})
+        {
+            RunCorpus(kind, entries);
+        }
+    }
+    RunParallelScaling(std::min<size_t>(entries / 10, 1000000));
+    return 0;
+}
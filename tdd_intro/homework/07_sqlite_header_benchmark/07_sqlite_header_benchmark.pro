@@ -0,0 +1,27 @@
+TEMPLATE = app
+CONFIG += console c++17 thread release
+CONFIG -= app_bundle
+CONFIG -= qt
+
+INCLUDEPATH += ../07_sqlite_header_parser
+
+SOURCES += \
+    benchmark.cpp \
+    ../07_sqlite_header_parser/DbReader.cpp \
+    ../07_sqlite_header_parser/FileIo.cpp \
+    ../07_sqlite_header_parser/HeaderBatchReader.cpp \
+    ../07_sqlite_header_parser/HeaderCache.cpp \
+    ../07_sqlite_header_parser/HeaderScanner.cpp \
+    ../07_sqlite_header_parser/HeaderDisplay.cpp \
+    ../07_sqlite_header_parser/HeaderValidator.cpp
+
+HEADERS += \
+    ../07_sqlite_header_parser/Interfaces.h \
+    ../07_sqlite_header_parser/SqliteFormat.h \
+    ../07_sqlite_header_parser/FileIo.h \
+    ../07_sqlite_header_parser/HeaderBatchReader.h \
+    ../07_sqlite_header_parser/HeaderCache.h \
+    ../07_sqlite_header_parser/HeaderScanner.h \
+    ../07_sqlite_header_parser/DbReader.h \
+    ../07_sqlite_header_parser/HeaderDisplay.h \
+    ../07_sqlite_header_parser/HeaderValidator.h
@@ -0,0 +1,280 @@
+/*
+Throughput benchmark for the SQLite header decoder.
+
+Usage: 07_sqlite_header_benchmark [headers in the corpus, default 1000000] [files, default 20000]
+
+The corpus is kept in memory, 100 bytes per header one after another:
+  valid     - headers passing every validation rule
+  corrupted - valid headers where 10% get one random byte changed
+  random    - random bytes
+
+Every function is repeated over the corpus for at least a quarter of a second and
+reported with headers/s and ns/header.
+
+The second part writes the valid corpus as files to a temporary directory and compares
+files/s of blocking reads against io_uring batches, once for a single HeaderBatchReader and
+once for the whole HeaderScanner, and then a rescan where every file hits the HeaderCache. The files stay in the page cache, so only the system call
+and scheduling overhead is measured, not the disk.
+*/
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "DbReader.h"
+#include "HeaderBatchReader.h"
+#include "HeaderCache.h"
+#include "HeaderDisplay.h"
+#include "HeaderScanner.h"
+#include "HeaderValidator.h"
+#include "SqliteFormat.h"
+
+enum class CorpusKind
+{
+    Valid,
+    Corrupted,
+    Random
+};
+
+const char* CorpusName(CorpusKind kind)
+{
+    switch (kind)
+    {
+    case CorpusKind::Valid:
+        return "valid";
+    case CorpusKind::Corrupted:
+        return "corrupted";
+    default:
+        return "random";
+    }
+}
+
+void WriteBigEndian32(unsigned char* bytes, uint32_t value)
+{
+    bytes[0] = static_cast<unsigned char>(value >> 24);
+    bytes[1] = static_cast<unsigned char>(value >> 16);
+    bytes[2] = static_cast<unsigned char>(value >> 8);
+    bytes[3] = static_cast<unsigned char>(value);
+}
+
+void MakeValidHeader(std::mt19937& random, unsigned char* bytes)
+{
+    std::memset(bytes, 0, g_sqliteHeaderSize);
+    std::memcpy(bytes, g_sqliteMagic, g_sqliteMagicSize);
+    const unsigned pageSize = 1u << (9 + random() % 8);
+    bytes[16] = static_cast<unsigned char>(pageSize == 65536 ? 0 : pageSize >> 8);
+    bytes[17] = pageSize == 65536 ? 1 : 0; // 65536 is stored as 1
+    bytes[18] = bytes[19] = static_cast<unsigned char>(1 + random() % 2);
+    bytes[21] = 64;
+    bytes[22] = 32;
+    bytes[23] = 32;
+    const uint32_t changeCounter = random();
+    const uint32_t pageCount = 2 + random() % 100000;
+    const uint32_t freelistPages = random() % pageCount;
+    WriteBigEndian32(bytes + 24, changeCounter);
+    WriteBigEndian32(bytes + 28, pageCount);
+    WriteBigEndian32(bytes + 32, freelistPages == 0 ? 0 : 2);
+    WriteBigEndian32(bytes + 36, freelistPages);
+    WriteBigEndian32(bytes + 40, 1 + random() % 1000);
+    WriteBigEndian32(bytes + 44, 4);
+    WriteBigEndian32(bytes + 56, 1 + random() % 3);
+    WriteBigEndian32(bytes + 92, changeCounter);
+    WriteBigEndian32(bytes + 96, 3045000);
+}
+
+std::vector<unsigned char> MakeCorpus(CorpusKind kind, size_t count)
+{
+    std::mt19937 random(static_cast<unsigned>(count) + static_cast<unsigned>(kind));
+    std::vector<unsigned char> corpus(count * g_sqliteHeaderSize);
+    for (size_t entry = 0; entry < count; ++entry)
+    {
+        unsigned char* bytes = corpus.data() + entry * g_sqliteHeaderSize;
+        if (kind == CorpusKind::Random)
+        {
+            for (size_t i = 0; i < g_sqliteHeaderSize; ++i)
+            {
+                bytes[i] = static_cast<unsigned char>(random());
+            }
+            continue;
+        }
+        MakeValidHeader(random, bytes);
+        if (kind == CorpusKind::Corrupted && random() % 10 == 0)
+        {
+            bytes[random() % g_sqliteHeaderSize] ^= static_cast<unsigned char>(1 + random() % 255);
+        }
+    }
+    return corpus;
+}
+
+// Runs the function over the corpus until a quarter of a second has passed and prints one row.
+// The function returns a value depending on its results, so nothing is optimized away.
+template <typename Function>
+void Measure(const char* function, const char* corpus, size_t headers, Function run)
+{
+    size_t rounds = 0;
+    size_t result = 0;
+    double seconds = 0;
+    const auto start = std::chrono::steady_clock::now();
+    do
+    {
+        result = run();
+        ++rounds;
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    } while (seconds < 0.25);
+
+    const double decoded = static_cast<double>(headers) * rounds;
+    std::cout << std::left << std::setw(24) << function << std::setw(12) << corpus
+              << std::right << std::setw(10) << headers
+              << std::fixed << std::setprecision(0) << std::setw(16) << decoded / seconds
+              << std::setprecision(1) << std::setw(12) << seconds * 1e9 / decoded
+              << std::setw(12) << result << std::endl;
+}
+
+void RunCorpus(CorpusKind kind, size_t headers)
+{
+    const char* corpus = CorpusName(kind);
+    const std::vector<unsigned char> bytes = MakeCorpus(kind, headers);
+    std::vector<uint32_t> violations(headers);
+
+    Measure("DecodeSqliteHeader", corpus, headers, [&]()
+    {
+        size_t pageSizes = 0;
+        for (size_t entry = 0; entry < headers; ++entry)
+        {
+            pageSizes += DecodeSqliteHeader(bytes.data() + entry * g_sqliteHeaderSize).pageSize;
+        }
+        return pageSizes;
+    });
+    Measure("ValidateHeader", corpus, headers, [&]()
+    {
+        size_t valid = 0;
+        for (size_t entry = 0; entry < headers; ++entry)
+        {
+            valid += ValidateHeader(bytes.data() + entry * g_sqliteHeaderSize) == 0;
+        }
+        return valid;
+    });
+    Measure("ValidateHeaders", corpus, headers, [&]()
+    {
+        ValidateHeaders(bytes.data(), headers, violations.data());
+        size_t valid = 0;
+        for (uint32_t violation : violations)
+        {
+            valid += violation == 0;
+        }
+        return valid;
+    });
+    Measure("decode+validate", corpus, headers, [&]()
+    {
+        size_t valid = 0;
+        for (size_t entry = 0; entry < headers; ++entry)
+        {
+            const unsigned char* header = bytes.data() + entry * g_sqliteHeaderSize;
+            valid += ValidateHeader(header) == 0 && DecodeSqliteHeader(header).pageCount > 0;
+        }
+        return valid;
+    });
+    Measure("FormatHeaderLines", corpus, headers, [&]()
+    {
+        size_t characters = 0;
+        for (size_t entry = 0; entry < headers; ++entry)
+        {
+            for (const std::string& line : FormatHeaderLines(DecodeSqliteHeader(bytes.data() + entry * g_sqliteHeaderSize)))
+            {
+                characters += line.size();
+            }
+        }
+        return characters;
+    });
+}
+
+void RunFileReads(size_t files)
+{
+    namespace fs = std::filesystem;
+    const fs::path root = fs::temp_directory_path() / "sqlite_header_benchmark";
+    fs::remove_all(root);
+    fs::create_directories(root);
+    const std::vector<unsigned char> bytes = MakeCorpus(CorpusKind::Valid, files);
+    std::vector<std::string> paths;
+    paths.reserve(files);
+    for (size_t entry = 0; entry < files; ++entry)
+    {
+        paths.push_back((root / (std::to_string(entry) + ".db")).string());
+        std::ofstream file(paths.back(), std::ios::binary);
+        file.write(reinterpret_cast<const char*>(bytes.data() + entry * g_sqliteHeaderSize), g_sqliteHeaderSize);
+    }
+    // files written just now are read but never cached, see g_racyModificationNs
+    const auto written = fs::file_time_type::clock::now() - std::chrono::hours(1);
+    for (const std::string& path : paths)
+    {
+        fs::last_write_time(path, written);
+    }
+
+    const HeaderBatchReader probe(true);
+    std::cout << "\nFile reads, " << files << " files, io_uring "
+              << (probe.UsesIoUring() ? "available" : "unavailable, both rows use blocking reads") << std::endl;
+    for (bool useIoUring : {false, true})
+    {
+        HeaderBatchReader reader(useIoUring);
+        Measure(useIoUring ? "HeaderBatchReader ring" : "HeaderBatchReader pread", "files", files, [&]()
+        {
+            size_t valid = 0;
+            reader.Read(paths, [&valid](size_t, const unsigned char* header, int64_t size)
+            {
+                valid += size == static_cast<int64_t>(g_sqliteHeaderSize) && ValidateHeader(header) == 0;
+            });
+            return valid;
+        });
+    }
+    for (bool useIoUring : {false, true})
+    {
+        const HeaderScanner scanner(0, 256, useIoUring);
+        Measure(useIoUring ? "HeaderScanner ring" : "HeaderScanner pread", "files", files, [&]()
+        {
+            return scanner.Scan(root.string()).sqliteFiles;
+        });
+    }
+
+    const std::string cachePath = (fs::temp_directory_path() / "sqlite_header_benchmark.cache").string();
+    HeaderCache cache;
+    const HeaderScanner scanner(0, 256, true);
+    scanner.Scan(root.string(), nullptr, &cache);
+    cache.Save(cachePath);
+    cache.Load(cachePath);
+    Measure("HeaderScanner cached", "files", files, [&]()
+    {
+        return scanner.Scan(root.string(), nullptr, &cache).cacheHits;
+    });
+    std::remove(cachePath.c_str());
+    fs::remove_all(root);
+}
+
+int main(int argc, char* argv[])
+{
+    const long headers = argc > 1 ? std::atol(argv[1]) : 1000000;
+    const long files = argc > 2 ? std::atol(argv[2]) : 20000;
+    if (headers < 1 || files < 0)
+    {
+        std::cerr << "Usage: " << argv[0] << " [headers in the corpus, at least 1] [files]" << std::endl;
+        return 1;
+    }
+
+    std::cout << std::left << std::setw(24) << "function" << std::setw(12) << "corpus"
+              << std::right << std::setw(10) << "headers" << std::setw(16) << "headers/s"
+              << std::setw(12) << "ns/header" << std::setw(12) << "result" << std::endl;
+    for (CorpusKind kind : {CorpusKind::Valid, CorpusKind::Corrupted, CorpusKind::Random})
+    {
+        RunCorpus(kind, static_cast<size_t>(headers));
+    }
+    if (files > 0)
+    {
+        RunFileReads(static_cast<size_t>(files));
+    }
+    return 0;
+}
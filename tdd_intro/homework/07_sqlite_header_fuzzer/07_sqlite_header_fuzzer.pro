@@ -0,0 +1,36 @@
+TEMPLATE = app
+CONFIG += console c++17
+CONFIG -= app_bundle
+CONFIG -= qt
+
+INCLUDEPATH += ../07_sqlite_header_parser
+
+# "qmake CONFIG+=libfuzzer" links the libFuzzer driver, otherwise the built in
+# replay/random driver is used, so the target also builds with gcc.
+libfuzzer {
+    QMAKE_CXX = clang++
+    QMAKE_LINK = clang++
+    QMAKE_CXXFLAGS += -fsanitize=fuzzer,address,undefined -g
+    QMAKE_LFLAGS += -fsanitize=fuzzer,address,undefined
+} else {
+    DEFINES += SQLITE_HEADER_FUZZER_STANDALONE
+    !win32 {
+        QMAKE_CXXFLAGS += -fsanitize=address,undefined -g
+        QMAKE_LFLAGS += -fsanitize=address,undefined
+    }
+}
+
+SOURCES += \
+    fuzzer.cpp \
+    ../07_sqlite_header_parser/DbReader.cpp \
+    ../07_sqlite_header_parser/FileIo.cpp \
+    ../07_sqlite_header_parser/HeaderDisplay.cpp \
+    ../07_sqlite_header_parser/HeaderValidator.cpp
+
+HEADERS += \
+    ../07_sqlite_header_parser/Interfaces.h \
+    ../07_sqlite_header_parser/SqliteFormat.h \
+    ../07_sqlite_header_parser/FileIo.h \
+    ../07_sqlite_header_parser/DbReader.h \
+    ../07_sqlite_header_parser/HeaderDisplay.h \
+    ../07_sqlite_header_parser/HeaderValidator.h
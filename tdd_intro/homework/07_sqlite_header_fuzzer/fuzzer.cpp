@@ -0,0 +1,157 @@
+/*
+Fuzzing entry point for the SQLite header decoder.
+
+Every input is cut to the 100 header bytes and copied into a heap buffer of exactly that size,
+so the address sanitizer reports any read past the header. The decoded header, the validator
+and the display lines are then cross checked against each other.
+
+Built with CONFIG+=libfuzzer the libFuzzer driver calls LLVMFuzzerTestOneInput.
+The standalone build replays the given files, or runs random headers when there are none:
+  07_sqlite_header_fuzzer [file ...]
+  07_sqlite_header_fuzzer --random [iterations, default 1000000] [seed]
+*/
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+#include "DbReader.h"
+#include "HeaderDisplay.h"
+#include "HeaderValidator.h"
+#include "SqliteFormat.h"
+
+#define FUZZ_CHECK(condition) \
+    do \
+    { \
+        if (!(condition)) \
+        { \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            std::abort(); \
+        } \
+    } while (false)
+
+namespace
+{
+    size_t CountBits(uint32_t value)
+    {
+        size_t count = 0;
+        for (; value != 0; value &= value - 1)
+        {
+            ++count;
+        }
+        return count;
+    }
+
+    void CheckHeader(const unsigned char* bytes)
+    {
+        const SqliteHeader header = DecodeSqliteHeader(bytes);
+        FUZZ_CHECK(header.head.size() <= g_sqliteMagicSize);
+        FUZZ_CHECK(header.head.find('\0') == std::string::npos);
+        FUZZ_CHECK(header.pageSize >= 0 && header.pageSize <= 65536);
+
+        const uint32_t violations = ValidateHeader(bytes);
+        FUZZ_CHECK(violations < (1u << g_headerViolationsCount));
+        FUZZ_CHECK(DescribeViolations(violations).size() == CountBits(violations));
+        if ((violations & ViolationMagic) == 0)
+        {
+            FUZZ_CHECK(std::memcmp(bytes, g_sqliteMagic, g_sqliteMagicSize) == 0);
+            FUZZ_CHECK(header.head.size() == g_sqliteMagicSize - 1);
+        }
+        if ((violations & ViolationPageSize) == 0)
+        {
+            FUZZ_CHECK(header.pageSize >= 512 && (header.pageSize & (header.pageSize - 1)) == 0);
+        }
+        if ((violations & (ViolationPageSize | ViolationUnusedBytes)) == 0)
+        {
+            FUZZ_CHECK(header.pageSize - header.bytesOfUnused >= 480);
+        }
+
+        uint32_t batchViolations = 0;
+        ValidateHeaders(bytes, 1, &batchViolations);
+        FUZZ_CHECK(batchViolations == violations);
+
+        for (const std::string& line : FormatHeaderLines(header))
+        {
+            FUZZ_CHECK(!line.empty());
+        }
+    }
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    if (size < g_sqliteHeaderSize)
+    {
+        return 0;
+    }
+    std::unique_ptr<unsigned char[]> bytes(new unsigned char[g_sqliteHeaderSize]);
+    std::memcpy(bytes.get(), data, g_sqliteHeaderSize);
+    CheckHeader(bytes.get());
+    return 0;
+}
+
+#ifdef SQLITE_HEADER_FUZZER_STANDALONE
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <vector>
+
+namespace
+{
+    // Random bytes alone almost never pass the magic check, so most inputs
+    // start from a valid header and only get a few bytes changed.
+    void MakeRandomHeader(std::mt19937& random, unsigned char* bytes)
+    {
+        for (size_t i = 0; i < g_sqliteHeaderSize; ++i)
+        {
+            bytes[i] = static_cast<unsigned char>(random());
+        }
+        if (random() % 4 == 0)
+        {
+            return;
+        }
+        std::memcpy(bytes, g_sqliteMagic, g_sqliteMagicSize);
+        const unsigned char validFields[] = {0x10, 0x00, 1, 1, 0, 64, 32, 32};
+        std::memcpy(bytes + 16, validFields, sizeof(validFields));
+        std::memset(bytes + 72, 0, 20);
+        for (unsigned changes = random() % 4; changes > 0; --changes)
+        {
+            bytes[random() % g_sqliteHeaderSize] = static_cast<unsigned char>(random());
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc > 1 && std::strcmp(argv[1], "--random") != 0)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::ifstream file(argv[i], std::ios::binary);
+            if (!file)
+            {
+                std::cerr << "Cannot open " << argv[i] << std::endl;
+                return 1;
+            }
+            const std::vector<uint8_t> input((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            LLVMFuzzerTestOneInput(input.data(), input.size());
+        }
+        std::cout << argc - 1 << " inputs replayed" << std::endl;
+        return 0;
+    }
+
+    const unsigned long iterations = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1000000;
+    std::mt19937 random(argc > 3 ? static_cast<unsigned>(std::strtoul(argv[3], nullptr, 10)) : 1);
+    uint8_t bytes[g_sqliteHeaderSize];
+    for (unsigned long i = 0; i < iterations; ++i)
+    {
+        MakeRandomHeader(random, bytes);
+        LLVMFuzzerTestOneInput(bytes, sizeof(bytes));
+    }
+    std::cout << iterations << " random headers checked" << std::endl;
+    return 0;
+}
+
+#endif
@@ -1,12 +1,59 @@
 include(../../gmock.pri)
 
 TEMPLATE = app
-CONFIG += console c++11
+CONFIG += console c++17 thread
 CONFIG -= app_bundle
 CONFIG -= qt
 
 SOURCES += \
-    test.cpp
+    test.cpp \
+    DbReader.cpp \
+    DbReaderTest.cpp \
+    HeaderDisplay.cpp \
+    HeaderScanner.cpp \
+    HeaderScannerTest.cpp \
+    FileIo.cpp \
+    PageReader.cpp \
+    PageReaderTest.cpp \
+    FreelistAnalyzer.cpp \
+    FreelistAnalyzerTest.cpp \
+    BtreeStats.cpp \
+    BtreeStatsTest.cpp \
+    HeaderWatcher.cpp \
+    HeaderWatcherTest.cpp \
+    WalIndex.cpp \
+    WalIndexTest.cpp \
+    HeaderFormatter.cpp \
+    HeaderFormatterTest.cpp \
+    HeaderValidator.cpp \
+    HeaderValidatorTest.cpp \
+    SchemaReader.cpp \
+    SchemaReaderTest.cpp \
+    Xxh64.cpp \
+    PageHasher.cpp \
+    PageHasherTest.cpp \
+    HeaderBatchReader.cpp \
+    HeaderBatchReaderTest.cpp \
+    HeaderCache.cpp \
+    HeaderCacheTest.cpp
 HEADERS += \
     Interfaces.h\
-    Mocks.h
+    Mocks.h \
+    SqliteFormat.h \
+    DbReader.h \
+    HeaderDisplay.h \
+    HeaderScanner.h \
+    TestFiles.h \
+    FileIo.h \
+    PageReader.h \
+    FreelistAnalyzer.h \
+    BtreeStats.h \
+    HeaderWatcher.h \
+    WalIndex.h \
+    HeaderFormatter.h \
+    HeaderValidator.h \
+    SchemaReader.h \
+    Xxh64.h \
+    PageHasher.h \
+    HeaderBatchReader.h \
+    HeaderCache.h
@@ -0,0 +1,217 @@
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#endif
+
+#include "BtreeStats.h"
+#include "DbReader.h"
+#include "FileIo.h"
+#include "FreelistAnalyzer.h"
+
+namespace
+{
+    PageKind KindOf(unsigned char pageType)
+    {
+        switch (pageType)
+        {
+        case g_interiorIndexPage:
+            return PageKind::InteriorIndex;
+        case g_interiorTablePage:
+            return PageKind::InteriorTable;
+        case g_leafIndexPage:
+            return PageKind::LeafIndex;
+        case g_leafTablePage:
+            return PageKind::LeafTable;
+        default:
+            return PageKind::Other;
+        }
+    }
+
+    // Returns false when the cell runs out of the page
+    bool CountOverflow(const unsigned char* cell, const unsigned char* end, PageKind kind, BtreeStats& stats)
+    {
+        if (kind == PageKind::InteriorTable)
+        {
+            return cell + 4 < end; // child pointer and rowid only
+        }
+        if (kind == PageKind::InteriorIndex)
+        {
+            cell += 4;
+        }
+        uint64_t payloadSize = 0;
+        const size_t sizeLength = ReadVarint(cell, end, payloadSize);
+        if (sizeLength == 0)
+        {
+            return false;
+        }
+        const uint64_t localSize = LocalPayloadSize(payloadSize, stats.usableSize, kind == PageKind::LeafTable);
+        if (localSize < payloadSize)
+        {
+            const uint64_t overflowBytesPerPage = stats.usableSize - 4;
+            ++stats.overflowChains;
+            stats.overflowPages += (payloadSize - localSize + overflowBytesPerPage - 1) / overflowBytesPerPage;
+        }
+        return true;
+    }
+
+    // headerOffset is 100 for the first page and 0 for every other one
+    void CollectPage(const unsigned char* page, size_t headerOffset, BtreeStats& stats)
+    {
+        ++stats.pagesScanned;
+        const unsigned char* header = page + headerOffset;
+        const PageKind kind = KindOf(header[0]);
+        PageKindStats& kindStats = stats.kinds[static_cast<size_t>(kind)];
+        ++kindStats.pages;
+        if (kind == PageKind::Other)
+        {
+            return;
+        }
+
+        const uint32_t usableSize = stats.usableSize;
+        const bool interior = kind == PageKind::InteriorIndex || kind == PageKind::InteriorTable;
+        const uint32_t pointersBegin = static_cast<uint32_t>(headerOffset) + (interior ? 12 : 8);
+        const uint32_t cellCount = ReadBigEndian16(header + 3);
+        uint32_t contentBegin = ReadBigEndian16(header + 5);
+        contentBegin = contentBegin == 0 ? 65536 : contentBegin;
+        const uint32_t pointersEnd = pointersBegin + 2 * cellCount;
+        if (pointersEnd > contentBegin || contentBegin > usableSize)
+        {
+            ++stats.corruptPages;
+            return;
+        }
+
+        uint32_t freeBytes = contentBegin - pointersEnd + header[7];
+        uint32_t freeblock = ReadBigEndian16(header + 1);
+        while (freeblock != 0)
+        {
+            if (freeblock < contentBegin || freeblock + 4 > usableSize)
+            {
+                ++stats.corruptPages;
+                return;
+            }
+            freeBytes += ReadBigEndian16(page + freeblock + 2);
+            const uint32_t next = ReadBigEndian16(page + freeblock);
+            if (next != 0 && next <= freeblock)
+            {
+                ++stats.corruptPages; // freeblocks are sorted, anything else is a loop
+                return;
+            }
+            freeblock = next;
+        }
+        if (freeBytes > usableSize)
+        {
+            ++stats.corruptPages;
+            return;
+        }
+
+        const unsigned char* end = page + usableSize;
+        for (uint32_t i = 0; i < cellCount; ++i)
+        {
+            const uint32_t cellOffset = ReadBigEndian16(page + pointersBegin + 2 * i);
+            if (cellOffset < contentBegin || cellOffset >= usableSize ||
+                !CountOverflow(page + cellOffset, end, kind, stats))
+            {
+                ++stats.corruptPages;
+                return;
+            }
+        }
+        kindStats.cells += cellCount;
+        kindStats.usableBytes += usableSize;
+        kindStats.usedBytes += usableSize - freeBytes;
+    }
+
+    // Auto-vacuum databases have a pointer map page in front of every usableSize / 5 pages,
+    // the first one is page 2 and one falling on the lock-byte page moves to the next page
+    bool IsPointerMapPage(uint64_t pageNumber, uint32_t usableSize, uint64_t lockBytePage)
+    {
+        if (pageNumber < 2)
+        {
+            return false;
+        }
+        const uint64_t pagesPerMap = usableSize / 5 + 1;
+        uint64_t mapPage = (pageNumber - 2) / pagesPerMap * pagesPerMap + 2;
+        if (mapPage == lockBytePage)
+        {
+            ++mapPage;
+        }
+        return pageNumber == mapPage;
+    }
+
+    void AdviseSequential(const File& file)
+    {
+#if !defined(_WIN32) && defined(POSIX_FADV_SEQUENTIAL)
+        ::posix_fadvise(file.Descriptor(), 0, 0, POSIX_FADV_SEQUENTIAL);
+#else
+        (void)file;
+#endif
+    }
+}
+
+BtreeStats CollectBtreeStats(const std::string& filePath, size_t chunkBytes)
+{
+    File file;
+    if (!file.Open(filePath))
+    {
+        throw std::runtime_error("Can not open " + filePath);
+    }
+    const SqliteHeader header = ReadDatabaseHeader(file, filePath);
+    AdviseSequential(file);
+
+    BtreeStats stats;
+    stats.pageSize = static_cast<uint32_t>(header.pageSize);
+    stats.usableSize = stats.pageSize - static_cast<uint32_t>(header.bytesOfUnused);
+
+    // Freed pages keep their old b-tree bytes and a pointer map entry may start with a b-tree
+    // page type, so neither kind can be told apart by its first byte. The freelist is found
+    // by reading only its trunk pages before the pass.
+    std::vector<uint32_t> freePages;
+    if (header.firstFreelistPage != 0)
+    {
+        PageReader reader(filePath, 1, 0);
+        AnalyzeFreelist(reader, &freePages);
+        std::sort(freePages.begin(), freePages.end());
+        stats.bytesRead += reader.Counters().bytesRead;
+    }
+    const bool autoVacuum = header.numberOfLargestRootPage != 0;
+    const uint64_t lockBytePage = 0x40000000 / stats.pageSize + 1;
+    auto nextFreePage = freePages.begin();
+
+    const size_t pagesInChunk = std::max<size_t>(1, chunkBytes / stats.pageSize);
+    std::vector<unsigned char> chunk(pagesInChunk * stats.pageSize);
+    uint64_t offset = 0;
+    while (true)
+    {
+        const int64_t bytesRead = file.ReadAt(chunk.data(), chunk.size(), offset);
+        if (bytesRead < 0)
+        {
+            throw std::runtime_error("Can not read " + filePath);
+        }
+        stats.bytesRead += static_cast<uint64_t>(bytesRead);
+        const size_t pages = static_cast<size_t>(bytesRead) / stats.pageSize; // a torn last page is ignored
+        for (size_t i = 0; i < pages; ++i)
+        {
+            const uint64_t pageNumber = offset / stats.pageSize + i + 1;
+            while (nextFreePage != freePages.end() && *nextFreePage < pageNumber)
+            {
+                ++nextFreePage;
+            }
+            if ((nextFreePage != freePages.end() && *nextFreePage == pageNumber) ||
+                (autoVacuum && IsPointerMapPage(pageNumber, stats.usableSize, lockBytePage)))
+            {
+                ++stats.pagesScanned;
+                ++stats.kinds[static_cast<size_t>(PageKind::Other)].pages;
+                continue;
+            }
+            CollectPage(chunk.data() + i * stats.pageSize, offset == 0 && i == 0 ? g_sqliteHeaderSize : 0, stats);
+        }
+        if (static_cast<size_t>(bytesRead) < chunk.size())
+        {
+            break;
+        }
+        offset += chunk.size();
+    }
+    return stats;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+enum class PageKind
+{
+    InteriorIndex,
+    InteriorTable,
+    LeafIndex,
+    LeafTable,
+    Other // freelist, overflow, pointer map and lock-byte pages
+};
+
+const size_t g_pageKindsCount = 5;
+const size_t g_defaultStatsChunkBytes = 4 * 1024 * 1024;
+
+struct PageKindStats
+{
+    uint64_t pages = 0;
+    uint64_t cells = 0;
+    uint64_t usedBytes = 0;
+    uint64_t usableBytes = 0;
+
+    double FillFactor() const
+    {
+        return usableBytes == 0 ? 0.0 : static_cast<double>(usedBytes) / usableBytes;
+    }
+};
+
+struct BtreeStats
+{
+    uint32_t pageSize = 0;
+    uint32_t usableSize = 0;
+    uint64_t pagesScanned = 0;
+    PageKindStats kinds[g_pageKindsCount];
+    uint64_t overflowChains = 0; // cells with a payload spilled to overflow pages
+    uint64_t overflowPages = 0; // pages in those chains, computed from the payload sizes
+    uint64_t corruptPages = 0; // b-tree pages whose cells do not fit the page
+    uint64_t bytesRead = 0;
+
+    const PageKindStats& Kind(PageKind kind) const
+    {
+        return kinds[static_cast<size_t>(kind)];
+    }
+};
+
+// Classifies every page of a database file in one sequential pass. The file is streamed
+// in chunks of about chunkBytes, so memory use does not depend on the file size.
+// Overflow chains are sized from the cells instead of being followed, the pass never seeks back.
+// Only the freelist trunk pages are read before the pass, freelist and pointer map pages are
+// counted as Other whatever bytes they hold.
+// Throws std::runtime_error when the file can not be opened or has no valid header.
+BtreeStats CollectBtreeStats(const std::string& filePath, size_t chunkBytes = g_defaultStatsChunkBytes);
@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+
+#include "BtreeStats.h"
+#include "TestFiles.h"
+
+using namespace test;
+
+namespace
+{
+    const char* const s_testFile = "btreestats_test.db";
+    const uint16_t s_pageSize = 1024;
+
+    class TestDatabase
+    {
+    public:
+        explicit TestDatabase(const std::vector<unsigned char>& bytes)
+        {
+            WriteTestFile(s_testFile, bytes);
+        }
+
+        ~TestDatabase()
+        {
+            std::remove(s_testFile);
+        }
+    };
+
+    std::vector<unsigned char> LeafTableCell(uint64_t payloadSize, uint64_t localSize, uint64_t rowid)
+    {
+        std::vector<unsigned char> cell;
+        AppendVarint(cell, payloadSize);
+        AppendVarint(cell, rowid);
+        cell.resize(cell.size() + localSize + (localSize < payloadSize ? 4 : 0), 0x11);
+        return cell;
+    }
+
+    std::vector<unsigned char> BtreeDatabase()
+    {
+        std::vector<unsigned char> bytes = MakeDatabaseBytes(s_pageSize, 5);
+        PageWriter(bytes, s_pageSize, 1, g_leafTablePage);
+
+        PageWriter interior(bytes, s_pageSize, 2, g_interiorTablePage);
+        interior.AddCell({0, 0, 0, 3, 5}); // left child 3, rowid 5
+
+        PageWriter leaf(bytes, s_pageSize, 3, g_leafTablePage);
+        leaf.AddCell(LeafTableCell(10, 10, 1));
+        leaf.AddCell(LeafTableCell(5000, 920, 2));
+
+        PageWriter index(bytes, s_pageSize, 4, g_leafIndexPage);
+        index.AddCell({3, 1, 2, 3});
+        WriteBigEndian32(bytes, 4 * s_pageSize, 0); // page 5 is the last page of an overflow chain
+        return bytes;
+    }
+}
+
+TEST(BtreeStats, FileNotExist)
+{
+    ASSERT_THROW(CollectBtreeStats("no_such_file.db"), std::runtime_error);
+}
+
+TEST(BtreeStats, ClassifyPages)
+{
+    TestDatabase database(BtreeDatabase());
+    const BtreeStats stats = CollectBtreeStats(s_testFile);
+
+    EXPECT_EQ(5u, stats.pagesScanned);
+    EXPECT_EQ(5u * s_pageSize, stats.bytesRead);
+    EXPECT_EQ(0u, stats.Kind(PageKind::InteriorIndex).pages);
+    EXPECT_EQ(1u, stats.Kind(PageKind::InteriorTable).pages);
+    EXPECT_EQ(1u, stats.Kind(PageKind::LeafIndex).pages);
+    EXPECT_EQ(2u, stats.Kind(PageKind::LeafTable).pages);
+    EXPECT_EQ(1u, stats.Kind(PageKind::Other).pages);
+    EXPECT_EQ(0u, stats.corruptPages);
+}
+
+TEST(BtreeStats, CellsAndFillFactor)
+{
+    TestDatabase database(BtreeDatabase());
+    const BtreeStats stats = CollectBtreeStats(s_testFile);
+
+    EXPECT_EQ(1u, stats.Kind(PageKind::InteriorTable).cells);
+    EXPECT_EQ(1u, stats.Kind(PageKind::LeafIndex).cells);
+    EXPECT_EQ(2u, stats.Kind(PageKind::LeafTable).cells);
+    // page 1: database header and page header, page 3: page header, two pointers and both cells
+    EXPECT_EQ(108u + 8 + 4 + 12 + 927, stats.Kind(PageKind::LeafTable).usedBytes);
+    EXPECT_EQ(2u * s_pageSize, stats.Kind(PageKind::LeafTable).usableBytes);
+    EXPECT_DOUBLE_EQ(1059.0 / 2048, stats.Kind(PageKind::LeafTable).FillFactor());
+}
+
+TEST(BtreeStats, OverflowChainsFromPayloadSize)
+{
+    TestDatabase database(BtreeDatabase());
+    const BtreeStats stats = CollectBtreeStats(s_testFile);
+
+    EXPECT_EQ(1u, stats.overflowChains);
+    EXPECT_EQ(4u, stats.overflowPages); // 4080 spilled bytes in 1020 byte pages
+}
+
+TEST(BtreeStats, SmallChunksGiveSameResult)
+{
+    TestDatabase database(BtreeDatabase());
+    const BtreeStats whole = CollectBtreeStats(s_testFile);
+    const BtreeStats chunked = CollectBtreeStats(s_testFile, 1);
+
+    EXPECT_EQ(whole.pagesScanned, chunked.pagesScanned);
+    EXPECT_EQ(whole.Kind(PageKind::LeafTable).usedBytes, chunked.Kind(PageKind::LeafTable).usedBytes);
+    EXPECT_EQ(whole.overflowPages, chunked.overflowPages);
+}
+
+TEST(BtreeStats, CellPointerOutsidePage)
+{
+    std::vector<unsigned char> bytes = BtreeDatabase();
+    WriteBigEndian16(bytes, 2 * s_pageSize + 8, 2000);
+    TestDatabase database(bytes);
+    const BtreeStats stats = CollectBtreeStats(s_testFile);
+
+    EXPECT_EQ(1u, stats.corruptPages);
+}
+
+TEST(BtreeStats, FreelistPagesWithStaleBytes)
+{
+    std::vector<unsigned char> bytes = BtreeDatabase();
+    bytes.resize(6 * s_pageSize, 0);
+    WriteBigEndian32(bytes, 28, 6);
+    WriteBigEndian32(bytes, 32, 6); // trunk page 6 with leaf page 3, which still looks like a table leaf
+    WriteBigEndian32(bytes, 36, 2);
+    WriteBigEndian32(bytes, 5 * s_pageSize + 4, 1);
+    WriteBigEndian32(bytes, 5 * s_pageSize + 8, 3);
+    TestDatabase database(bytes);
+    const BtreeStats stats = CollectBtreeStats(s_testFile);
+
+    EXPECT_EQ(6u, stats.pagesScanned);
+    EXPECT_EQ(1u, stats.Kind(PageKind::LeafTable).pages);
+    EXPECT_EQ(0u, stats.Kind(PageKind::LeafTable).cells);
+    EXPECT_EQ(3u, stats.Kind(PageKind::Other).pages);
+    EXPECT_EQ(0u, stats.overflowChains);
+}
+
+TEST(BtreeStats, PointerMapPagesOfAutoVacuum)
+{
+    std::vector<unsigned char> bytes = MakeDatabaseBytes(s_pageSize, 3);
+    PageWriter(bytes, s_pageSize, 1, g_leafTablePage);
+    PageWriter(bytes, s_pageSize, 3, g_leafTablePage);
+    WriteBigEndian32(bytes, 52, 3);
+    bytes[s_pageSize] = 5; // the entry of page 3, a root page, starts like an interior table page
+    TestDatabase database(bytes);
+    const BtreeStats stats = CollectBtreeStats(s_testFile);
+
+    EXPECT_EQ(0u, stats.Kind(PageKind::InteriorTable).pages);
+    EXPECT_EQ(2u, stats.Kind(PageKind::LeafTable).pages);
+    EXPECT_EQ(1u, stats.Kind(PageKind::Other).pages);
+    EXPECT_EQ(0u, stats.corruptPages);
+}
+
+TEST(BtreeStats, Varint)
+{
+    const unsigned char oneByte[] = {0x7f};
+    const unsigned char twoBytes[] = {0x81, 0x00};
+    const unsigned char nineBytes[] = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
+    uint64_t value = 0;
+    EXPECT_EQ(1u, ReadVarint(oneByte, oneByte + 1, value));
+    EXPECT_EQ(0x7fu, value);
+    EXPECT_EQ(2u, ReadVarint(twoBytes, twoBytes + 2, value));
+    EXPECT_EQ(0x80u, value);
+    EXPECT_EQ(9u, ReadVarint(nineBytes, nineBytes + 9, value));
+    EXPECT_EQ(~0ull, value);
+    EXPECT_EQ(0u, ReadVarint(twoBytes, twoBytes + 1, value));
+}
@@ -0,0 +1,207 @@
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "DbReader.h"
+#include "FileIo.h"
+#include "HeaderValidator.h"
+
+SqliteHeader DecodeSqliteHeader(const unsigned char* bytes)
+{
+    SqliteHeader header;
+    header.head.assign(reinterpret_cast<const char*>(bytes),
+                       ::strnlen(reinterpret_cast<const char*>(bytes), g_sqliteMagicSize));
+    const int pageSize = ReadBigEndian16(bytes + 16);
+    header.pageSize = pageSize == 1 ? 65536 : pageSize;
+    header.fileFormatWriteVersion = bytes[18];
+    header.fileFormatReadVersion = bytes[19];
+    header.bytesOfUnused = bytes[20];
+    header.maximumEmbeddedPayloadFraction = bytes[21];
+    header.minimumEmbeddedPayloadFraction = bytes[22];
+    header.leafPayloadFraction = bytes[23];
+    header.fileChangeCounter = static_cast<int>(ReadBigEndian32(bytes + 24));
+    header.pageCount = static_cast<int>(ReadBigEndian32(bytes + 28));
+    header.firstFreelistPage = static_cast<int>(ReadBigEndian32(bytes + 32));
+    header.freelistPageCount = static_cast<int>(ReadBigEndian32(bytes + 36));
+    header.schemaFormat = static_cast<int>(ReadBigEndian32(bytes + 44));
+    header.defaultPageCacheSize = static_cast<int>(ReadBigEndian32(bytes + 48));
+    header.numberOfLargestRootPage = static_cast<int>(ReadBigEndian32(bytes + 52));
+    header.databaseTextEncoding = static_cast<int>(ReadBigEndian32(bytes + 56));
+    header.userVersion = static_cast<int>(ReadBigEndian32(bytes + 60));
+    header.incrementalVacuumMode = static_cast<int>(ReadBigEndian32(bytes + 64));
+    header.applicationId = static_cast<int>(ReadBigEndian32(bytes + 68));
+    header.versionValidNumber = static_cast<int>(ReadBigEndian32(bytes + 92));
+    header.sqliteVersionNumber = static_cast<int>(ReadBigEndian32(bytes + 96));
+    return header;
+}
+
+SqliteHeader ReadDatabaseHeader(const File& file, const std::string& filePath)
+{
+    unsigned char bytes[g_sqliteHeaderSize];
+    if (file.ReadAt(bytes, sizeof(bytes), 0) != static_cast<int64_t>(sizeof(bytes)) ||
+        std::memcmp(bytes, g_sqliteMagic, g_sqliteMagicSize) != 0)
+    {
+        throw std::runtime_error("No SQLite header in " + filePath);
+    }
+    const SqliteHeader header = DecodeSqliteHeader(bytes);
+    if (header.pageSize < 512 || (header.pageSize & (header.pageSize - 1)) != 0 ||
+        header.bytesOfUnused > header.pageSize - 480)
+    {
+        throw std::runtime_error("Invalid page size in " + filePath);
+    }
+    return header;
+}
+
+DbReader::DbReader()
+    : m_header()
+    , m_bytesRead(0)
+    , m_validHeader(false)
+    , m_violations(~0u)
+{
+}
+
+bool DbReader::ReadFilePath(const std::string& filePath)
+{
+    unsigned char bytes[g_sqliteHeaderSize];
+    File file;
+    const int64_t bytesRead = file.Open(filePath) ? file.ReadAt(bytes, sizeof(bytes), 0) : -1;
+    return ReadBytes(bytes, bytesRead);
+}
+
+bool DbReader::ReadBytes(const unsigned char* bytes, int64_t size)
+{
+    // a short file leaves the missing fields zero
+    unsigned char header[g_sqliteHeaderSize] = {};
+    m_bytesRead = size > 0 ? std::min<size_t>(static_cast<size_t>(size), g_sqliteHeaderSize) : 0;
+    std::memcpy(header, bytes, m_bytesRead);
+    m_validHeader = m_bytesRead == g_sqliteHeaderSize &&
+                    std::memcmp(header, g_sqliteMagic, g_sqliteMagicSize) == 0;
+    m_header = DecodeSqliteHeader(header);
+    m_violations = m_bytesRead == g_sqliteHeaderSize ? ValidateHeader(header) : ~0u;
+    return size >= 0;
+}
+
+bool DbReader::CheckHeader()
+{
+    return m_validHeader;
+}
+
+std::string DbReader::GetHeaderString()
+{
+    return m_header.head;
+}
+
+int DbReader::GetPageSize()
+{
+    return m_header.pageSize;
+}
+
+int DbReader::GetFormatWriteVersion()
+{
+    return m_header.fileFormatWriteVersion;
+}
+
+int DbReader::GetFormatReadVersion()
+{
+    return m_header.fileFormatReadVersion;
+}
+
+int DbReader::GetUnsedBytes()
+{
+    return m_header.bytesOfUnused;
+}
+
+int DbReader::GetMaximumEmbeddedPayloadFraction()
+{
+    return m_header.maximumEmbeddedPayloadFraction;
+}
+
+int DbReader::GetMinimumEmbeddedPayloadFraction()
+{
+    return m_header.minimumEmbeddedPayloadFraction;
+}
+
+int DbReader::GetLeafPayloadFraction()
+{
+    return m_header.leafPayloadFraction;
+}
+
+int DbReader::GetFileChangeCounter()
+{
+    return m_header.fileChangeCounter;
+}
+
+int DbReader::GetPageCount()
+{
+    return m_header.pageCount;
+}
+
+int DbReader::GetFirstFreelistPage()
+{
+    return m_header.firstFreelistPage;
+}
+
+int DbReader::GetFreelistPageCount()
+{
+    return m_header.freelistPageCount;
+}
+
+int DbReader::GetSchemaFormat()
+{
+    return m_header.schemaFormat;
+}
+
+int DbReader::GetDefaultPageCacheSize()
+{
+    return m_header.defaultPageCacheSize;
+}
+
+int DbReader::GetNumberOfLargestRootPage()
+{
+    return m_header.numberOfLargestRootPage;
+}
+
+int DbReader::GetDatabaseTextEncoding()
+{
+    return m_header.databaseTextEncoding;
+}
+
+int DbReader::GetUserVersion()
+{
+    return m_header.userVersion;
+}
+
+int DbReader::GetIncrementalVacuumMode()
+{
+    return m_header.incrementalVacuumMode;
+}
+
+int DbReader::GetApplicationId()
+{
+    return m_header.applicationId;
+}
+
+int DbReader::GetVersionValidNumber()
+{
+    return m_header.versionValidNumber;
+}
+
+int DbReader::GetSqliteVersionNumber()
+{
+    return m_header.sqliteVersionNumber;
+}
+
+bool DbReader::IsEmpty()
+{
+    return m_bytesRead == 0;
+}
+
+SqliteHeader DbReader::ReadHeader()
+{
+    return m_header;
+}
+
+uint32_t DbReader::GetViolations() const
+{
+    return m_violations;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Interfaces.h"
+#include "SqliteFormat.h"
+
+// Decodes the 100-byte database header, bytes must hold g_sqliteHeaderSize bytes
+SqliteHeader DecodeSqliteHeader(const unsigned char* bytes);
+
+class File;
+// Reads and decodes the header of an opened database file for the page level readers.
+// Throws std::runtime_error when there is no header or the page size is invalid.
+SqliteHeader ReadDatabaseHeader(const File& file, const std::string& filePath);
+
+// Reads the header of a database file with a single 100-byte read at offset 0.
+// All fields are decoded at once, the getters do no further I/O.
+class DbReader : public IDbReader
+{
+public:
+    DbReader();
+    bool ReadFilePath(const std::string& filePath);
+    // Decodes bytes read from offset 0 elsewhere, size is -1 when the read failed.
+    // Returns false on a failed read like ReadFilePath.
+    bool ReadBytes(const unsigned char* bytes, int64_t size);
+    bool CheckHeader();
+    std::string GetHeaderString();
+    int GetPageSize();
+    int GetFormatWriteVersion();
+    int GetFormatReadVersion();
+    int GetUnsedBytes();
+    int GetMaximumEmbeddedPayloadFraction();
+    int GetMinimumEmbeddedPayloadFraction();
+    int GetLeafPayloadFraction();
+    int GetFileChangeCounter();
+    int GetPageCount();
+    int GetFirstFreelistPage();
+    int GetFreelistPageCount();
+    int GetSchemaFormat();
+    int GetDefaultPageCacheSize();
+    int GetNumberOfLargestRootPage();
+    int GetDatabaseTextEncoding();
+    int GetUserVersion();
+    int GetIncrementalVacuumMode();
+    int GetApplicationId();
+    int GetVersionValidNumber();
+    int GetSqliteVersionNumber();
+    bool IsEmpty();
+    SqliteHeader ReadHeader();
+    // HeaderViolation bits of the last read header, every bit is set when less than 100 bytes were read
+    uint32_t GetViolations() const;
+
+private:
+    SqliteHeader m_header;
+    size_t m_bytesRead;
+    bool m_validHeader;
+    uint32_t m_violations;
+};
@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+
+#include "DbReader.h"
+#include "HeaderValidator.h"
+#include "TestFiles.h"
+
+namespace
+{
+    const char* const s_testFile = "dbreader_test.db";
+
+    void WriteTestFile(const std::vector<unsigned char>& bytes)
+    {
+        test::WriteTestFile(s_testFile, bytes);
+    }
+}
+
+using namespace test;
+
+TEST(DbReader, FileNotExist)
+{
+    DbReader reader;
+    ASSERT_FALSE(reader.ReadFilePath("no_such_file.db"));
+    ASSERT_TRUE(reader.IsEmpty());
+    ASSERT_FALSE(reader.CheckHeader());
+}
+
+TEST(DbReader, EmptyFile)
+{
+    WriteTestFile({});
+    DbReader reader;
+    ASSERT_TRUE(reader.ReadFilePath(s_testFile));
+    std::remove(s_testFile);
+
+    ASSERT_TRUE(reader.IsEmpty());
+    ASSERT_FALSE(reader.CheckHeader());
+}
+
+TEST(DbReader, FileLessThan100Byte)
+{
+    std::vector<unsigned char> bytes = MakeHeaderBytes();
+    bytes.resize(99);
+    WriteTestFile(bytes);
+    DbReader reader;
+    ASSERT_TRUE(reader.ReadFilePath(s_testFile));
+    std::remove(s_testFile);
+
+    ASSERT_FALSE(reader.IsEmpty());
+    ASSERT_FALSE(reader.CheckHeader());
+}
+
+TEST(DbReader, WrongHeaderString)
+{
+    std::vector<unsigned char> bytes = MakeHeaderBytes();
+    bytes[0] = 'X';
+    WriteTestFile(bytes);
+    DbReader reader;
+    ASSERT_TRUE(reader.ReadFilePath(s_testFile));
+    std::remove(s_testFile);
+
+    ASSERT_FALSE(reader.CheckHeader());
+}
+
+TEST(DbReader, ReadAllFields)
+{
+    std::vector<unsigned char> bytes = MakeHeaderBytes();
+    bytes.resize(4096, 0xAB); // the rest of the first page
+    WriteTestFile(bytes);
+    DbReader reader;
+    ASSERT_TRUE(reader.ReadFilePath(s_testFile));
+    std::remove(s_testFile);
+
+    ASSERT_FALSE(reader.IsEmpty());
+    ASSERT_TRUE(reader.CheckHeader());
+    EXPECT_EQ("SQLite format 3", reader.GetHeaderString());
+    EXPECT_EQ(4096, reader.GetPageSize());
+    EXPECT_EQ(2, reader.GetFormatWriteVersion());
+    EXPECT_EQ(2, reader.GetFormatReadVersion());
+    EXPECT_EQ(8, reader.GetUnsedBytes());
+    EXPECT_EQ(64, reader.GetMaximumEmbeddedPayloadFraction());
+    EXPECT_EQ(32, reader.GetMinimumEmbeddedPayloadFraction());
+    EXPECT_EQ(32, reader.GetLeafPayloadFraction());
+    EXPECT_EQ(0x01020304, reader.GetFileChangeCounter());
+    EXPECT_EQ(30, reader.GetPageCount());
+    EXPECT_EQ(20, reader.GetFirstFreelistPage());
+    EXPECT_EQ(5, reader.GetFreelistPageCount());
+    EXPECT_EQ(4, reader.GetSchemaFormat());
+    EXPECT_EQ(2000, reader.GetDefaultPageCacheSize());
+    EXPECT_EQ(3, reader.GetNumberOfLargestRootPage());
+    EXPECT_EQ(1, reader.GetDatabaseTextEncoding());
+    EXPECT_EQ(42, reader.GetUserVersion());
+    EXPECT_EQ(1, reader.GetIncrementalVacuumMode());
+    EXPECT_EQ(0x0F0F0F0F, reader.GetApplicationId());
+    EXPECT_EQ(0x01020304, reader.GetVersionValidNumber());
+    EXPECT_EQ(3024000, reader.GetSqliteVersionNumber());
+}
+
+TEST(DbReader, ReadHeaderAtOnce)
+{
+    WriteTestFile(MakeHeaderBytes());
+    DbReader reader;
+    ASSERT_TRUE(reader.ReadFilePath(s_testFile));
+    std::remove(s_testFile);
+
+    const SqliteHeader header = reader.ReadHeader();
+    EXPECT_EQ("SQLite format 3", header.head);
+    EXPECT_EQ(4096, header.pageSize);
+    EXPECT_EQ(30, header.pageCount);
+    EXPECT_EQ(42, header.userVersion);
+    EXPECT_EQ(3024000, header.sqliteVersionNumber);
+}
+
+TEST(DbReader, Violations)
+{
+    std::vector<unsigned char> bytes = MakeHeaderBytes();
+    WriteTestFile(bytes);
+    DbReader reader;
+    ASSERT_TRUE(reader.ReadFilePath(s_testFile));
+    EXPECT_EQ(0u, reader.GetViolations());
+
+    bytes[23] = 0;
+    WriteTestFile(bytes);
+    ASSERT_TRUE(reader.ReadFilePath(s_testFile));
+    EXPECT_EQ(ViolationLeafPayloadFraction, reader.GetViolations());
+
+    bytes.resize(50);
+    WriteTestFile(bytes);
+    ASSERT_TRUE(reader.ReadFilePath(s_testFile));
+    std::remove(s_testFile);
+    EXPECT_EQ(~0u, reader.GetViolations());
+}
+
+TEST(DbReader, PageSize65536)
+{
+    std::vector<unsigned char> bytes = MakeHeaderBytes();
+    WriteBigEndian16(bytes, 16, 1);
+    const SqliteHeader header = DecodeSqliteHeader(bytes.data());
+    ASSERT_EQ(65536, header.pageSize);
+}
+
+TEST(DbReader, ReadAnotherFile)
+{
+    WriteTestFile(MakeHeaderBytes());
+    DbReader reader;
+    ASSERT_TRUE(reader.ReadFilePath(s_testFile));
+    ASSERT_TRUE(reader.CheckHeader());
+
+    WriteTestFile({'n', 'o'});
+    ASSERT_TRUE(reader.ReadFilePath(s_testFile));
+    std::remove(s_testFile);
+
+    ASSERT_FALSE(reader.CheckHeader());
+    ASSERT_EQ(0, reader.GetPageSize());
+}
@@ -0,0 +1,103 @@
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "FileIo.h"
+
+File::File()
+    : m_fd(-1)
+{
+}
+
+File::~File()
+{
+    Close();
+}
+
+bool File::Open(const std::string& filePath)
+{
+    Close();
+#ifdef _WIN32
+    m_fd = ::_open(filePath.c_str(), _O_RDONLY | _O_BINARY);
+#else
+    m_fd = ::open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+#endif
+    return m_fd != -1;
+}
+
+void File::Close()
+{
+    if (m_fd != -1)
+    {
+#ifdef _WIN32
+        ::_close(m_fd);
+#else
+        ::close(m_fd);
+#endif
+        m_fd = -1;
+    }
+}
+
+bool File::IsOpen() const
+{
+    return m_fd != -1;
+}
+
+int File::Descriptor() const
+{
+    return m_fd;
+}
+
+int64_t File::Size() const
+{
+#ifdef _WIN32
+    struct _stat64 status;
+    if (::_fstat64(m_fd, &status) != 0)
+    {
+        return -1;
+    }
+#else
+    struct stat status;
+    if (::fstat(m_fd, &status) != 0)
+    {
+        return -1;
+    }
+#endif
+    return static_cast<int64_t>(status.st_size);
+}
+
+int64_t File::ReadAt(void* buffer, size_t size, uint64_t offset) const
+{
+    char* destination = static_cast<char*>(buffer);
+    size_t total = 0;
+    while (total < size)
+    {
+#ifdef _WIN32
+        // no pread on Windows, the descriptor is not shared between threads here
+        if (::_lseeki64(m_fd, static_cast<__int64>(offset + total), SEEK_SET) == -1)
+        {
+            return -1;
+        }
+        const int bytesRead = ::_read(m_fd, destination + total, static_cast<unsigned int>(size - total));
+#else
+        const ssize_t bytesRead = ::pread(m_fd, destination + total, size - total,
+                                          static_cast<off_t>(offset + total));
+#endif
+        if (bytesRead < 0)
+        {
+            return -1;
+        }
+        if (bytesRead == 0)
+        {
+            break;
+        }
+        total += static_cast<size_t>(bytesRead);
+    }
+    return static_cast<int64_t>(total);
+}
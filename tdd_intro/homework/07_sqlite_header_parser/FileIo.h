@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Read-only file descriptor with positional reads, closed on destruction
+class File
+{
+public:
+    File();
+    ~File();
+    File(const File&) = delete;
+    File& operator=(const File&) = delete;
+
+    bool Open(const std::string& filePath);
+    void Close();
+    bool IsOpen() const;
+    int Descriptor() const;
+    // Returns -1 when the size can not be determined
+    int64_t Size() const;
+    // Reads up to size bytes at offset without moving a shared file position, repeats short reads.
+    // Returns the number of bytes read, less than size only at the end of file, or -1 on failure.
+    int64_t ReadAt(void* buffer, size_t size, uint64_t offset) const;
+
+private:
+    int m_fd;
+};
@@ -0,0 +1,59 @@
+#include <unordered_set>
+
+#include "FreelistAnalyzer.h"
+#include "SqliteFormat.h"
+
+FreelistReport AnalyzeFreelist(PageReader& reader, std::vector<uint32_t>* freePages)
+{
+    const SqliteHeader& header = reader.Header();
+    const uint32_t pageCount = reader.PageCount();
+    const uint32_t usableSize = reader.PageSize() - static_cast<uint32_t>(header.bytesOfUnused);
+    const uint32_t maxLeafCount = usableSize / 4 - 2;
+    const uint64_t bytesReadBefore = reader.Counters().bytesRead;
+
+    FreelistReport report;
+    report.databaseBytes = static_cast<uint64_t>(pageCount) * reader.PageSize();
+
+    std::unordered_set<uint32_t> visitedTrunks;
+    uint32_t trunk = static_cast<uint32_t>(header.firstFreelistPage);
+    while (trunk != 0)
+    {
+        if (trunk > pageCount || !visitedTrunks.insert(trunk).second)
+        {
+            report.consistent = false;
+            break;
+        }
+        const unsigned char* page = reader.ReadPage(trunk);
+        const uint32_t leafCount = ReadBigEndian32(page + 4);
+        ++report.trunkPages;
+        if (leafCount > maxLeafCount)
+        {
+            report.consistent = false;
+            break;
+        }
+        report.leafPages += leafCount;
+        if (freePages != nullptr)
+        {
+            freePages->push_back(trunk);
+            for (uint32_t i = 0; i < leafCount; ++i)
+            {
+                freePages->push_back(ReadBigEndian32(page + 8 + 4 * i));
+            }
+        }
+        trunk = ReadBigEndian32(page);
+    }
+
+    if (report.FreePages() != static_cast<uint32_t>(header.freelistPageCount))
+    {
+        report.consistent = false;
+    }
+    report.reclaimableBytes = static_cast<uint64_t>(report.FreePages()) * reader.PageSize();
+    report.bytesRead = reader.Counters().bytesRead - bytesReadBefore;
+    return report;
+}
+
+FreelistReport AnalyzeFreelist(const std::string& filePath)
+{
+    PageReader reader(filePath, 1, 0);
+    return AnalyzeFreelist(reader);
+}
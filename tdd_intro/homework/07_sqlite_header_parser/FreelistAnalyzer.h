@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "PageReader.h"
+
+struct FreelistReport
+{
+    uint32_t trunkPages = 0;
+    uint32_t leafPages = 0;
+    uint64_t reclaimableBytes = 0; // what VACUUM would give back
+    uint64_t databaseBytes = 0;
+    uint64_t bytesRead = 0; // I/O spent on the walk
+    bool consistent = true; // the chain agrees with the header and has no loops
+
+    uint32_t FreePages() const
+    {
+        return trunkPages + leafPages;
+    }
+};
+
+// Follows the freelist trunk chain starting at the header's first trunk page.
+// Only trunk pages are read, leaf pages are counted from the trunk entries.
+// When freePages is given the numbers of the trunk and leaf pages are appended to it.
+FreelistReport AnalyzeFreelist(PageReader& reader, std::vector<uint32_t>* freePages = nullptr);
+
+// Opens the file without mapping and with a single page buffer, so I/O is exactly the trunk pages
+FreelistReport AnalyzeFreelist(const std::string& filePath);
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+
+#include "FreelistAnalyzer.h"
+#include "TestFiles.h"
+
+using namespace test;
+
+namespace
+{
+    const char* const s_testFile = "freelist_test.db";
+    const uint16_t s_pageSize = 1024;
+
+    class TestDatabase
+    {
+    public:
+        explicit TestDatabase(const std::vector<unsigned char>& bytes)
+        {
+            WriteTestFile(s_testFile, bytes);
+        }
+
+        ~TestDatabase()
+        {
+            std::remove(s_testFile);
+        }
+    };
+
+    void SetFreelist(std::vector<unsigned char>& bytes, uint32_t firstTrunk, uint32_t freePages)
+    {
+        WriteBigEndian32(bytes, 32, firstTrunk);
+        WriteBigEndian32(bytes, 36, freePages);
+    }
+
+    void WriteTrunk(std::vector<unsigned char>& bytes, uint32_t trunk, uint32_t next, const std::vector<uint32_t>& leaves)
+    {
+        const size_t offset = (trunk - 1) * s_pageSize;
+        WriteBigEndian32(bytes, offset, next);
+        WriteBigEndian32(bytes, offset + 4, static_cast<uint32_t>(leaves.size()));
+        for (size_t i = 0; i < leaves.size(); ++i)
+        {
+            WriteBigEndian32(bytes, offset + 8 + 4 * i, leaves[i]);
+        }
+    }
+}
+
+TEST(FreelistAnalyzer, NoFreelist)
+{
+    TestDatabase database(MakeDatabaseBytes(s_pageSize, 4));
+    const FreelistReport report = AnalyzeFreelist(s_testFile);
+    EXPECT_EQ(0u, report.FreePages());
+    EXPECT_EQ(0u, report.reclaimableBytes);
+    EXPECT_EQ(4u * s_pageSize, report.databaseBytes);
+    EXPECT_EQ(0u, report.bytesRead);
+    EXPECT_TRUE(report.consistent);
+}
+
+TEST(FreelistAnalyzer, ReadsOnlyTrunkPages)
+{
+    std::vector<unsigned char> bytes = MakeDatabaseBytes(s_pageSize, 10);
+    SetFreelist(bytes, 2, 7);
+    WriteTrunk(bytes, 2, 6, {3, 4, 5});
+    WriteTrunk(bytes, 6, 0, {7, 8});
+    TestDatabase database(bytes);
+
+    const FreelistReport report = AnalyzeFreelist(s_testFile);
+    EXPECT_EQ(2u, report.trunkPages);
+    EXPECT_EQ(5u, report.leafPages);
+    EXPECT_EQ(7u * s_pageSize, report.reclaimableBytes);
+    EXPECT_EQ(2u * s_pageSize, report.bytesRead);
+    EXPECT_TRUE(report.consistent);
+}
+
+TEST(FreelistAnalyzer, CountDisagreesWithHeader)
+{
+    std::vector<unsigned char> bytes = MakeDatabaseBytes(s_pageSize, 4);
+    SetFreelist(bytes, 2, 5);
+    WriteTrunk(bytes, 2, 0, {3});
+    TestDatabase database(bytes);
+
+    const FreelistReport report = AnalyzeFreelist(s_testFile);
+    EXPECT_EQ(2u, report.FreePages());
+    EXPECT_FALSE(report.consistent);
+}
+
+TEST(FreelistAnalyzer, TrunkLoop)
+{
+    std::vector<unsigned char> bytes = MakeDatabaseBytes(s_pageSize, 4);
+    SetFreelist(bytes, 2, 2);
+    WriteTrunk(bytes, 2, 3, {});
+    WriteTrunk(bytes, 3, 2, {});
+    TestDatabase database(bytes);
+
+    const FreelistReport report = AnalyzeFreelist(s_testFile);
+    EXPECT_EQ(2u, report.trunkPages);
+    EXPECT_FALSE(report.consistent);
+}
+
+TEST(FreelistAnalyzer, TrunkOutOfFile)
+{
+    std::vector<unsigned char> bytes = MakeDatabaseBytes(s_pageSize, 4);
+    SetFreelist(bytes, 2, 3);
+    WriteTrunk(bytes, 2, 40, {3});
+    TestDatabase database(bytes);
+
+    const FreelistReport report = AnalyzeFreelist(s_testFile);
+    EXPECT_EQ(2u, report.FreePages());
+    EXPECT_FALSE(report.consistent);
+}
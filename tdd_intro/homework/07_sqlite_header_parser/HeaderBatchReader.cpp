@@ -0,0 +1,345 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "HeaderBatchReader.h"
+#include "FileIo.h"
+#include "SqliteFormat.h"
+
+#ifdef __linux__
+
+namespace
+{
+    const unsigned g_maxQueueDepth = 4096;
+
+    // Every file in flight owns a slot and has exactly one operation queued or running
+    enum Stage : uint64_t
+    {
+        StageOpen,
+        StageRead,
+        StageClose
+    };
+
+    inline uint64_t UserData(unsigned slot, Stage stage)
+    {
+        return static_cast<uint64_t>(slot) << 2 | stage;
+    }
+}
+
+// Raw io_uring without liburing: the submission and completion rings are mapped from the
+// ring descriptor and the kernel is entered once per round of submissions.
+struct HeaderBatchReader::Ring
+{
+    struct Slot
+    {
+        size_t index;
+        int fd;
+        unsigned char bytes[g_sqliteHeaderSize];
+    };
+
+    int fd = -1;
+    void* sqRing = MAP_FAILED;
+    void* cqRing = MAP_FAILED;
+    io_uring_sqe* sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+    size_t sqRingSize = 0;
+    size_t cqRingSize = 0;
+    unsigned entries = 0;
+
+    unsigned* sqHead = nullptr;
+    unsigned* sqTail = nullptr;
+    unsigned* sqMask = nullptr;
+    unsigned* sqArray = nullptr;
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned* cqMask = nullptr;
+    io_uring_cqe* cqes = nullptr;
+    unsigned localTail = 0; // published to the kernel on Enter
+    unsigned toSubmit = 0;
+
+    std::vector<Slot> slots;
+    std::vector<unsigned> freeSlots;
+
+    ~Ring()
+    {
+        if (sqes != MAP_FAILED)
+        {
+            ::munmap(sqes, entries * sizeof(io_uring_sqe));
+        }
+        if (cqRing != MAP_FAILED && cqRing != sqRing)
+        {
+            ::munmap(cqRing, cqRingSize);
+        }
+        if (sqRing != MAP_FAILED)
+        {
+            ::munmap(sqRing, sqRingSize);
+        }
+        if (fd != -1)
+        {
+            ::close(fd);
+        }
+    }
+
+    bool Init(unsigned queueDepth)
+    {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        fd = static_cast<int>(::syscall(__NR_io_uring_setup, queueDepth, &params));
+        if (fd < 0)
+        {
+            return false;
+        }
+        entries = params.sq_entries;
+        sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (singleMap)
+        {
+            sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+        }
+
+        const int protection = PROT_READ | PROT_WRITE;
+        const int flags = MAP_SHARED | MAP_POPULATE;
+        sqRing = ::mmap(nullptr, sqRingSize, protection, flags, fd, IORING_OFF_SQ_RING);
+        if (sqRing == MAP_FAILED)
+        {
+            return false;
+        }
+        cqRing = singleMap ? sqRing : ::mmap(nullptr, cqRingSize, protection, flags, fd, IORING_OFF_CQ_RING);
+        sqes = static_cast<io_uring_sqe*>(::mmap(nullptr, entries * sizeof(io_uring_sqe), protection, flags, fd, IORING_OFF_SQES));
+        if (cqRing == MAP_FAILED || sqes == MAP_FAILED)
+        {
+            return false;
+        }
+
+        char* sq = static_cast<char*>(sqRing);
+        sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        char* cq = static_cast<char*>(cqRing);
+        cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        localTail = *sqTail;
+
+        // the completion ring is at least as large as the submission ring, so it can not
+        // overflow while no more files than submission entries are in flight
+        slots.resize(entries);
+        for (unsigned slot = entries; slot > 0; --slot)
+        {
+            freeSlots.push_back(slot - 1);
+        }
+        return SupportsOpcodes();
+    }
+
+    // openat, read and close need Linux 5.6
+    bool SupportsOpcodes() const
+    {
+        const unsigned opsCount = 256;
+        std::vector<unsigned char> buffer(sizeof(io_uring_probe) + opsCount * sizeof(io_uring_probe_op));
+        io_uring_probe* probe = reinterpret_cast<io_uring_probe*>(buffer.data());
+        if (::syscall(__NR_io_uring_register, fd, IORING_REGISTER_PROBE, probe, opsCount) < 0)
+        {
+            return false;
+        }
+        for (unsigned opcode : {IORING_OP_OPENAT, IORING_OP_READ, IORING_OP_CLOSE})
+        {
+            if (opcode > probe->last_op || (probe->ops[opcode].flags & IO_URING_OP_SUPPORTED) == 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    io_uring_sqe* NextSqe(unsigned slot, Stage stage, uint8_t opcode, int fileDescriptor)
+    {
+        const unsigned index = localTail & *sqMask;
+        ++localTail;
+        ++toSubmit;
+        sqArray[index] = index;
+        io_uring_sqe* sqe = &sqes[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = opcode;
+        sqe->fd = fileDescriptor;
+        sqe->user_data = UserData(slot, stage);
+        return sqe;
+    }
+
+    void PrepareOpen(unsigned slot, const std::string& path)
+    {
+        io_uring_sqe* sqe = NextSqe(slot, StageOpen, IORING_OP_OPENAT, AT_FDCWD);
+        sqe->addr = reinterpret_cast<uint64_t>(path.c_str());
+        sqe->open_flags = O_RDONLY | O_CLOEXEC;
+    }
+
+    void PrepareRead(unsigned slot)
+    {
+        io_uring_sqe* sqe = NextSqe(slot, StageRead, IORING_OP_READ, slots[slot].fd);
+        sqe->addr = reinterpret_cast<uint64_t>(slots[slot].bytes);
+        sqe->len = sizeof(slots[slot].bytes);
+        sqe->off = 0;
+    }
+
+    void PrepareClose(unsigned slot)
+    {
+        NextSqe(slot, StageClose, IORING_OP_CLOSE, slots[slot].fd);
+    }
+
+    // Submits the prepared entries and waits for at least one completion
+    void Enter()
+    {
+        __atomic_store_n(sqTail, localTail, __ATOMIC_RELEASE);
+        const long submitted = ::syscall(__NR_io_uring_enter, fd, toSubmit, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+        if (submitted >= 0)
+        {
+            toSubmit -= static_cast<unsigned>(submitted);
+        }
+        else if (errno != EINTR && errno != EAGAIN && errno != EBUSY)
+        {
+            throw std::runtime_error(std::string("io_uring_enter failed: ") + std::strerror(errno));
+        }
+    }
+
+    void Read(const std::vector<std::string>& paths, const HeaderReadCallback& callback)
+    {
+        std::exception_ptr error;
+        const auto complete = [&](const Slot& slot, int64_t size)
+        {
+            if (!error)
+            {
+                try
+                {
+                    callback(slot.index, slot.bytes, size);
+                }
+                catch (...)
+                {
+                    error = std::current_exception();
+                }
+            }
+        };
+
+        size_t next = 0;
+        size_t inFlight = 0;
+        while (inFlight > 0 || (next < paths.size() && !error))
+        {
+            while (next < paths.size() && !error && !freeSlots.empty())
+            {
+                const unsigned slot = freeSlots.back();
+                freeSlots.pop_back();
+                slots[slot].index = next;
+                slots[slot].fd = -1;
+                PrepareOpen(slot, paths[next]);
+                ++next;
+                ++inFlight;
+            }
+            Enter();
+
+            unsigned head = *cqHead;
+            const unsigned tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+            for (; head != tail; ++head)
+            {
+                const io_uring_cqe& cqe = cqes[head & *cqMask];
+                const unsigned slot = static_cast<unsigned>(cqe.user_data >> 2);
+                switch (static_cast<Stage>(cqe.user_data & 3))
+                {
+                case StageOpen:
+                    if (cqe.res < 0)
+                    {
+                        complete(slots[slot], -1);
+                        freeSlots.push_back(slot);
+                        --inFlight;
+                    }
+                    else
+                    {
+                        slots[slot].fd = cqe.res;
+                        error ? PrepareClose(slot) : PrepareRead(slot);
+                    }
+                    break;
+                case StageRead:
+                    complete(slots[slot], cqe.res < 0 ? -1 : cqe.res);
+                    PrepareClose(slot);
+                    break;
+                default:
+                    freeSlots.push_back(slot);
+                    --inFlight;
+                    break;
+                }
+            }
+            __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+        }
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+};
+
+#else
+
+struct HeaderBatchReader::Ring
+{
+    void Read(const std::vector<std::string>&, const HeaderReadCallback&)
+    {
+    }
+};
+
+#endif
+
+HeaderBatchReader::HeaderBatchReader(bool useIoUring, unsigned queueDepth)
+{
+#ifdef __linux__
+    if (useIoUring)
+    {
+        std::unique_ptr<Ring> ring(new Ring());
+        if (ring->Init(std::min(std::max(1u, queueDepth), g_maxQueueDepth)))
+        {
+            m_ring = std::move(ring);
+        }
+    }
+#else
+    (void)useIoUring;
+    (void)queueDepth;
+#endif
+}
+
+HeaderBatchReader::~HeaderBatchReader() = default;
+
+bool HeaderBatchReader::UsesIoUring() const
+{
+    return m_ring != nullptr;
+}
+
+void HeaderBatchReader::Read(const std::vector<std::string>& paths, const HeaderReadCallback& callback)
+{
+    if (m_ring)
+    {
+        m_ring->Read(paths, callback);
+    }
+    else
+    {
+        ReadBlocking(paths, callback);
+    }
+}
+
+void HeaderBatchReader::ReadBlocking(const std::vector<std::string>& paths, const HeaderReadCallback& callback) const
+{
+    unsigned char bytes[g_sqliteHeaderSize];
+    for (size_t index = 0; index < paths.size(); ++index)
+    {
+        File file;
+        const int64_t size = file.Open(paths[index]) ? file.ReadAt(bytes, sizeof(bytes), 0) : -1;
+        callback(index, bytes, size);
+    }
+}
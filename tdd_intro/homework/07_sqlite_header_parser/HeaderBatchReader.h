@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Called once per path with the index of the path and the bytes read from offset 0.
+// size is -1 when the file could not be opened or read, bytes are valid during the call only.
+using HeaderReadCallback = std::function<void(size_t index, const unsigned char* bytes, int64_t size)>;
+
+// Reads the first 100 bytes of many files.
+// On Linux the open, read and close of up to queueDepth files at a time go through one
+// io_uring, so a batch costs a few system calls instead of three per file and the callback
+// runs as the reads complete, in no particular order. Without io_uring (other systems, old
+// kernels, seccomp filters) every file is opened and read with blocking calls in path order.
+// One reader is meant for one thread.
+class HeaderBatchReader
+{
+public:
+    explicit HeaderBatchReader(bool useIoUring = true, unsigned queueDepth = 256);
+    ~HeaderBatchReader();
+    HeaderBatchReader(const HeaderBatchReader&) = delete;
+    HeaderBatchReader& operator=(const HeaderBatchReader&) = delete;
+
+    bool UsesIoUring() const;
+    // An exception from callback stops new reads, the files in flight are still closed
+    // before it is rethrown.
+    void Read(const std::vector<std::string>& paths, const HeaderReadCallback& callback);
+
+private:
+    struct Ring;
+
+    void ReadBlocking(const std::vector<std::string>& paths, const HeaderReadCallback& callback) const;
+
+    std::unique_ptr<Ring> m_ring;
+};
@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+
+#include "HeaderBatchReader.h"
+#include "TestFiles.h"
+
+using namespace test;
+
+namespace
+{
+    struct ReadResult
+    {
+        int64_t size = -2;
+        std::vector<unsigned char> bytes;
+        size_t calls = 0;
+    };
+
+    class BatchFiles
+    {
+    public:
+        explicit BatchFiles(size_t count)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                const std::string path = "batch_reader_test_" + std::to_string(i) + ".db";
+                std::vector<unsigned char> bytes = MakeHeaderBytes();
+                bytes[24] = static_cast<unsigned char>(i);
+                bytes.resize(i % 3 == 2 ? 40 : bytes.size() + i);
+                WriteTestFile(path, bytes);
+                m_paths.push_back(path);
+            }
+        }
+
+        ~BatchFiles()
+        {
+            for (const std::string& path : m_paths)
+            {
+                std::remove(path.c_str());
+            }
+        }
+
+        const std::vector<std::string>& Paths() const
+        {
+            return m_paths;
+        }
+
+    private:
+        std::vector<std::string> m_paths;
+    };
+
+    std::vector<ReadResult> ReadAll(HeaderBatchReader& reader, const std::vector<std::string>& paths)
+    {
+        std::vector<ReadResult> results(paths.size());
+        reader.Read(paths, [&results](size_t index, const unsigned char* bytes, int64_t size)
+        {
+            ReadResult& result = results.at(index);
+            result.size = size;
+            result.bytes.assign(bytes, bytes + std::max<int64_t>(0, size));
+            ++result.calls;
+        });
+        return results;
+    }
+}
+
+TEST(HeaderBatchReader, ReadFirstBytesOfEveryFile)
+{
+    BatchFiles files(9);
+    std::vector<std::string> paths = files.Paths();
+    paths.insert(paths.begin() + 4, "no_such_file.db");
+    HeaderBatchReader reader;
+
+    const std::vector<ReadResult> results = ReadAll(reader, paths);
+    ASSERT_EQ(10u, results.size());
+    EXPECT_EQ(-1, results[4].size);
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        EXPECT_EQ(1u, results[i].calls);
+        if (i != 4)
+        {
+            const size_t file = i < 4 ? i : i - 1;
+            EXPECT_EQ(file % 3 == 2 ? 40 : 100, results[i].size);
+            EXPECT_EQ(static_cast<unsigned char>(file), results[i].bytes.at(24));
+        }
+    }
+}
+
+TEST(HeaderBatchReader, BlockingReadsGiveSameBytes)
+{
+    BatchFiles files(20);
+    HeaderBatchReader ring(true, 4);
+    HeaderBatchReader blocking(false);
+    EXPECT_FALSE(blocking.UsesIoUring());
+
+    const std::vector<ReadResult> ringResults = ReadAll(ring, files.Paths());
+    const std::vector<ReadResult> blockingResults = ReadAll(blocking, files.Paths());
+    for (size_t i = 0; i < files.Paths().size(); ++i)
+    {
+        EXPECT_EQ(blockingResults[i].size, ringResults[i].size);
+        EXPECT_EQ(blockingResults[i].bytes, ringResults[i].bytes);
+    }
+}
+
+TEST(HeaderBatchReader, CallbackExceptionLeavesReaderUsable)
+{
+    BatchFiles files(12);
+    HeaderBatchReader reader(true, 4);
+    size_t calls = 0;
+    ASSERT_THROW(reader.Read(files.Paths(), [&calls](size_t, const unsigned char*, int64_t)
+    {
+        if (++calls == 3)
+        {
+            throw std::runtime_error("stop");
+        }
+    }), std::runtime_error);
+    EXPECT_EQ(3u, calls);
+
+    const std::vector<ReadResult> results = ReadAll(reader, files.Paths());
+    for (const ReadResult& result : results)
+    {
+        EXPECT_EQ(1u, result.calls);
+    }
+}
@@ -0,0 +1,284 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <tuple>
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "HeaderCache.h"
+#include "FileIo.h"
+
+namespace
+{
+    const unsigned char g_cacheMagic[4] = {'S', 'Q', 'H', 'C'};
+    const uint32_t g_cacheVersion = 1;
+    const uint32_t g_byteOrderMark = 0x01020304; // entries are stored in the native byte order
+    const size_t g_cacheHeaderSize = 24;
+
+    static_assert(sizeof(HeaderCacheEntry) == 136, "cache entries must have no padding");
+
+    struct CacheFileHeader
+    {
+        unsigned char magic[4];
+        uint32_t version;
+        uint32_t byteOrder;
+        uint32_t entrySize;
+        uint64_t count;
+    };
+
+    static_assert(sizeof(CacheFileHeader) == g_cacheHeaderSize, "cache file header must have no padding");
+
+    // Forces the written bytes of filePath to the disk, so a rename over the old file can not
+    // leave an empty or partial file behind after a crash
+    bool SyncFile(const std::string& filePath)
+    {
+#ifdef _WIN32
+        const int fd = ::_open(filePath.c_str(), _O_WRONLY | _O_BINARY);
+        const bool synced = fd != -1 && ::_commit(fd) == 0;
+        if (fd != -1)
+        {
+            ::_close(fd);
+        }
+#else
+        const int fd = ::open(filePath.c_str(), O_WRONLY | O_CLOEXEC);
+        const bool synced = fd != -1 && ::fsync(fd) == 0;
+        if (fd != -1)
+        {
+            ::close(fd);
+        }
+#endif
+        return synced;
+    }
+}
+
+bool operator<(const FileKey& left, const FileKey& right)
+{
+    return std::tie(left.device, left.inode, left.size, left.modifiedNs) <
+           std::tie(right.device, right.inode, right.size, right.modifiedNs);
+}
+
+bool operator==(const FileKey& left, const FileKey& right)
+{
+    return left.device == right.device && left.inode == right.inode &&
+           left.size == right.size && left.modifiedNs == right.modifiedNs;
+}
+
+bool GetFileKey(const std::string& filePath, FileKey& key)
+{
+#ifdef _WIN32
+    (void)filePath;
+    (void)key;
+    return false;
+#else
+    struct stat status;
+    if (::stat(filePath.c_str(), &status) != 0)
+    {
+        return false;
+    }
+    key.device = static_cast<uint64_t>(status.st_dev);
+    key.inode = static_cast<uint64_t>(status.st_ino);
+    key.size = static_cast<uint64_t>(status.st_size);
+#ifdef __APPLE__
+    key.modifiedNs = static_cast<int64_t>(status.st_mtimespec.tv_sec) * 1000000000 + status.st_mtimespec.tv_nsec;
+#else
+    key.modifiedNs = static_cast<int64_t>(status.st_mtim.tv_sec) * 1000000000 + status.st_mtim.tv_nsec;
+#endif
+    return true;
+#endif
+}
+
+int64_t FileClockNowNs()
+{
+    const auto now = std::chrono::system_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+}
+
+HeaderCache::HeaderCache()
+    : m_mapping(nullptr)
+    , m_mappingSize(0)
+    , m_entries(nullptr)
+    , m_size(0)
+{
+}
+
+HeaderCache::~HeaderCache()
+{
+    Unmap();
+}
+
+void HeaderCache::Unmap()
+{
+#ifndef _WIN32
+    if (m_mapping != nullptr && m_buffer.empty())
+    {
+        ::munmap(const_cast<unsigned char*>(m_mapping), m_mappingSize);
+    }
+#endif
+    m_buffer.clear();
+    m_mapping = nullptr;
+    m_mappingSize = 0;
+    m_entries = nullptr;
+    m_size = 0;
+    m_used.reset();
+}
+
+bool HeaderCache::Load(const std::string& cachePath)
+{
+    Unmap();
+    {
+        std::lock_guard<std::mutex> lock(m_insertedMutex);
+        m_inserted.clear();
+    }
+
+    File file;
+    const int64_t fileSize = file.Open(cachePath) ? file.Size() : -1;
+    if (fileSize < static_cast<int64_t>(g_cacheHeaderSize))
+    {
+        return false;
+    }
+#ifndef _WIN32
+    void* mapping = ::mmap(nullptr, static_cast<size_t>(fileSize), PROT_READ, MAP_SHARED, file.Descriptor(), 0);
+    if (mapping == MAP_FAILED)
+    {
+        return false;
+    }
+    m_mapping = static_cast<const unsigned char*>(mapping);
+#else
+    m_buffer.resize(static_cast<size_t>(fileSize));
+    if (file.ReadAt(m_buffer.data(), m_buffer.size(), 0) != fileSize)
+    {
+        m_buffer.clear();
+        return false;
+    }
+    m_mapping = m_buffer.data();
+#endif
+    m_mappingSize = static_cast<size_t>(fileSize);
+
+    CacheFileHeader header;
+    std::memcpy(&header, m_mapping, sizeof(header));
+    const uint64_t entriesBytes = m_mappingSize - g_cacheHeaderSize;
+    if (std::memcmp(header.magic, g_cacheMagic, sizeof(g_cacheMagic)) != 0 ||
+        header.version != g_cacheVersion || header.byteOrder != g_byteOrderMark ||
+        header.entrySize != sizeof(HeaderCacheEntry) ||
+        header.count != entriesBytes / sizeof(HeaderCacheEntry) || entriesBytes % sizeof(HeaderCacheEntry) != 0)
+    {
+        Unmap();
+        return false;
+    }
+    m_entries = reinterpret_cast<const HeaderCacheEntry*>(m_mapping + g_cacheHeaderSize);
+    m_size = static_cast<size_t>(header.count);
+    // Find is a binary search, it needs every key greater than the one before
+    const HeaderCacheEntry* end = m_entries + m_size;
+    if (std::adjacent_find(m_entries, end, [](const HeaderCacheEntry& left, const HeaderCacheEntry& right)
+    {
+        return !(left.key < right.key);
+    }) != end || std::any_of(m_entries, end, [](const HeaderCacheEntry& entry)
+    {
+        return entry.size > g_sqliteHeaderSize;
+    }))
+    {
+        Unmap();
+        return false;
+    }
+    m_used.reset(new std::atomic<bool>[m_size]());
+    return true;
+}
+
+void HeaderCache::Save(const std::string& cachePath) const
+{
+    std::vector<HeaderCacheEntry> entries;
+    {
+        std::lock_guard<std::mutex> lock(m_insertedMutex);
+        entries = m_inserted;
+    }
+    for (size_t i = 0; i < m_size; ++i)
+    {
+        if (m_used[i].load(std::memory_order_relaxed))
+        {
+            entries.push_back(m_entries[i]);
+        }
+    }
+    // a key found and inserted at once keeps the inserted bytes
+    const auto byKey = [](const HeaderCacheEntry& left, const HeaderCacheEntry& right)
+    {
+        return left.key < right.key;
+    };
+    std::stable_sort(entries.begin(), entries.end(), byKey);
+    entries.erase(std::unique(entries.begin(), entries.end(), [](const HeaderCacheEntry& left, const HeaderCacheEntry& right)
+    {
+        return left.key == right.key;
+    }), entries.end());
+
+    CacheFileHeader header;
+    std::memcpy(header.magic, g_cacheMagic, sizeof(g_cacheMagic));
+    header.version = g_cacheVersion;
+    header.byteOrder = g_byteOrderMark;
+    header.entrySize = sizeof(HeaderCacheEntry);
+    header.count = entries.size();
+
+    const std::string temporaryPath = cachePath + ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(entries.data()),
+                   static_cast<std::streamsize>(entries.size() * sizeof(HeaderCacheEntry)));
+        if (!file.flush())
+        {
+            throw std::runtime_error("Can not write " + temporaryPath);
+        }
+    }
+    std::error_code error;
+    if (!SyncFile(temporaryPath))
+    {
+        std::filesystem::remove(temporaryPath, error);
+        throw std::runtime_error("Can not write " + temporaryPath);
+    }
+    std::filesystem::rename(temporaryPath, cachePath, error);
+    if (error)
+    {
+        std::filesystem::remove(temporaryPath, error);
+        throw std::runtime_error("Can not replace " + cachePath);
+    }
+}
+
+size_t HeaderCache::Size() const
+{
+    return m_size;
+}
+
+const HeaderCacheEntry* HeaderCache::Find(const FileKey& key) const
+{
+    const HeaderCacheEntry* end = m_entries + m_size;
+    const HeaderCacheEntry* entry = std::lower_bound(m_entries, end, key, [](const HeaderCacheEntry& left, const FileKey& right)
+    {
+        return left.key < right;
+    });
+    if (entry == end || !(entry->key == key))
+    {
+        return nullptr;
+    }
+    m_used[static_cast<size_t>(entry - m_entries)].store(true, std::memory_order_relaxed);
+    return entry;
+}
+
+void HeaderCache::Insert(const FileKey& key, const unsigned char* bytes, size_t size)
+{
+    HeaderCacheEntry entry;
+    std::memset(&entry, 0, sizeof(entry));
+    entry.key = key;
+    entry.size = static_cast<uint32_t>(std::min(size, g_sqliteHeaderSize));
+    std::memcpy(entry.bytes, bytes, entry.size);
+    std::lock_guard<std::mutex> lock(m_insertedMutex);
+    m_inserted.push_back(entry);
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "SqliteFormat.h"
+
+// Identity of one version of a file: a rewrite changes the size or the modification time
+struct FileKey
+{
+    uint64_t device;
+    uint64_t inode;
+    uint64_t size;
+    int64_t modifiedNs;
+};
+
+bool operator<(const FileKey& left, const FileKey& right);
+bool operator==(const FileKey& left, const FileKey& right);
+
+// One stat of filePath, false when it fails or the system has no inode numbers
+bool GetFileKey(const std::string& filePath, FileKey& key);
+
+// A file modified less than this before it was read may be written again within the same
+// timestamp tick, so its key would not change. Like git's racy index entries, such file
+// versions are not inserted into the cache.
+const int64_t g_racyModificationNs = 1000000000;
+
+// Current time in the clock of FileKey::modifiedNs
+int64_t FileClockNowNs();
+
+// The first bytes of one file version as stored in the cache file
+struct HeaderCacheEntry
+{
+    FileKey key;
+    uint32_t size; // bytes read from offset 0, less than 100 for short files
+    unsigned char bytes[g_sqliteHeaderSize];
+};
+
+// Persistent cache of the raw first 100 bytes of files, so a rescan of an unchanged tree only
+// needs a stat per file. The raw bytes are kept rather than decoded SqliteHeader values:
+// they are fixed size, can be used straight from the mapping and decode in a few nanoseconds.
+// The cache file is a small header followed by entries sorted by key, it is mapped read-only
+// and searched in place. Entries inserted during a scan become visible after Save and Load.
+class HeaderCache
+{
+public:
+    HeaderCache();
+    ~HeaderCache();
+    HeaderCache(const HeaderCache&) = delete;
+    HeaderCache& operator=(const HeaderCache&) = delete;
+
+    // Maps a file written by Save. A missing or malformed file, also one whose entries are
+    // not sorted by key or claim more bytes than they hold, leaves the cache empty.
+    bool Load(const std::string& cachePath);
+    // Writes the entries found or inserted since Load, entries of files that were not seen are
+    // dropped. The new file is synced to the disk and then renamed over the old one, so Save may
+    // target the loaded file and a crash leaves either the old or the new cache.
+    // Throws std::runtime_error when the file can not be written.
+    void Save(const std::string& cachePath) const;
+    size_t Size() const;
+
+    // Both are safe to call from several threads
+    const HeaderCacheEntry* Find(const FileKey& key) const;
+    void Insert(const FileKey& key, const unsigned char* bytes, size_t size);
+
+private:
+    void Unmap();
+
+    const unsigned char* m_mapping;
+    size_t m_mappingSize;
+    std::vector<unsigned char> m_buffer; // used instead of the mapping where there is no mmap
+    const HeaderCacheEntry* m_entries;
+    size_t m_size;
+    std::unique_ptr<std::atomic<bool>[]> m_used;
+    mutable std::mutex m_insertedMutex;
+    std::vector<HeaderCacheEntry> m_inserted;
+};
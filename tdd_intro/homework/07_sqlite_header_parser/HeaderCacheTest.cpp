@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+
+#include "HeaderCache.h"
+#include "TestFiles.h"
+
+using namespace test;
+
+namespace
+{
+    const char* const s_testFile = "header_cache_test.db";
+    const char* const s_cacheFile = "header_cache_test.cache";
+
+    class TestDatabase
+    {
+    public:
+        explicit TestDatabase(const std::vector<unsigned char>& bytes)
+        {
+            WriteTestFile(s_testFile, bytes);
+        }
+
+        ~TestDatabase()
+        {
+            std::remove(s_testFile);
+            std::remove(s_cacheFile);
+        }
+    };
+
+    FileKey MakeKey(uint64_t inode)
+    {
+        return FileKey{1, inode, 4096, 1000};
+    }
+}
+
+TEST(HeaderCache, FileKeyOfMissingFile)
+{
+    FileKey key;
+    ASSERT_FALSE(GetFileKey("no_such_file.db", key));
+}
+
+TEST(HeaderCache, FileKeyChangesWithContent)
+{
+    TestDatabase database(MakeHeaderBytes());
+    FileKey before;
+    ASSERT_TRUE(GetFileKey(s_testFile, before));
+    EXPECT_EQ(100u, before.size);
+
+    std::vector<unsigned char> bytes = MakeHeaderBytes();
+    bytes.push_back(0);
+    WriteTestFile(s_testFile, bytes);
+    FileKey after;
+    ASSERT_TRUE(GetFileKey(s_testFile, after));
+    EXPECT_FALSE(before == after);
+}
+
+TEST(HeaderCache, LoadMissingFile)
+{
+    HeaderCache cache;
+    ASSERT_FALSE(cache.Load("no_such_file.cache"));
+    EXPECT_EQ(0u, cache.Size());
+    EXPECT_EQ(nullptr, cache.Find(MakeKey(1)));
+}
+
+TEST(HeaderCache, LoadMalformedFile)
+{
+    TestDatabase database(MakeHeaderBytes());
+    HeaderCache cache;
+    ASSERT_FALSE(cache.Load(s_testFile));
+    EXPECT_EQ(0u, cache.Size());
+}
+
+TEST(HeaderCache, LoadEntriesNotSorted)
+{
+    TestDatabase database({});
+    const std::vector<unsigned char> header = MakeHeaderBytes();
+    HeaderCache cache;
+    cache.Insert(MakeKey(3), header.data(), header.size());
+    cache.Insert(MakeKey(7), header.data(), header.size());
+    cache.Save(s_cacheFile);
+
+    std::vector<unsigned char> bytes = ReadTestFile(s_cacheFile);
+    const size_t entries = bytes.size() - 2 * sizeof(HeaderCacheEntry);
+    std::rotate(bytes.begin() + entries, bytes.begin() + entries + sizeof(HeaderCacheEntry), bytes.end());
+    WriteTestFile(s_cacheFile, bytes);
+    ASSERT_FALSE(cache.Load(s_cacheFile));
+    EXPECT_EQ(0u, cache.Size());
+}
+
+TEST(HeaderCache, LoadEntryLargerThanHeader)
+{
+    TestDatabase database({});
+    const std::vector<unsigned char> header = MakeHeaderBytes();
+    HeaderCache cache;
+    cache.Insert(MakeKey(3), header.data(), header.size());
+    cache.Save(s_cacheFile);
+
+    std::vector<unsigned char> bytes = ReadTestFile(s_cacheFile);
+    const uint32_t size = g_sqliteHeaderSize + 1;
+    std::memcpy(bytes.data() + bytes.size() - sizeof(HeaderCacheEntry) + offsetof(HeaderCacheEntry, size), &size, sizeof(size));
+    WriteTestFile(s_cacheFile, bytes);
+    ASSERT_FALSE(cache.Load(s_cacheFile));
+    EXPECT_EQ(0u, cache.Size());
+}
+
+TEST(HeaderCache, InsertedEntriesVisibleAfterSaveAndLoad)
+{
+    TestDatabase database({});
+    const std::vector<unsigned char> header = MakeHeaderBytes();
+    HeaderCache cache;
+    cache.Insert(MakeKey(7), header.data(), header.size());
+    cache.Insert(MakeKey(3), header.data(), 10);
+    EXPECT_EQ(nullptr, cache.Find(MakeKey(7)));
+    cache.Save(s_cacheFile);
+
+    ASSERT_TRUE(cache.Load(s_cacheFile));
+    EXPECT_EQ(2u, cache.Size());
+    const HeaderCacheEntry* full = cache.Find(MakeKey(7));
+    ASSERT_NE(nullptr, full);
+    EXPECT_EQ(100u, full->size);
+    EXPECT_TRUE(std::equal(header.begin(), header.end(), full->bytes));
+    const HeaderCacheEntry* partial = cache.Find(MakeKey(3));
+    ASSERT_NE(nullptr, partial);
+    EXPECT_EQ(10u, partial->size);
+    EXPECT_EQ(nullptr, cache.Find(MakeKey(5)));
+}
+
+TEST(HeaderCache, SaveDropsEntriesNotFound)
+{
+    TestDatabase database({});
+    const std::vector<unsigned char> header = MakeHeaderBytes();
+    HeaderCache cache;
+    for (uint64_t inode = 1; inode <= 5; ++inode)
+    {
+        cache.Insert(MakeKey(inode), header.data(), header.size());
+    }
+    cache.Save(s_cacheFile);
+
+    ASSERT_TRUE(cache.Load(s_cacheFile));
+    ASSERT_NE(nullptr, cache.Find(MakeKey(2)));
+    ASSERT_NE(nullptr, cache.Find(MakeKey(4)));
+    cache.Insert(MakeKey(9), header.data(), header.size());
+    cache.Save(s_cacheFile);
+
+    ASSERT_TRUE(cache.Load(s_cacheFile));
+    EXPECT_EQ(3u, cache.Size());
+    EXPECT_EQ(nullptr, cache.Find(MakeKey(1)));
+    EXPECT_NE(nullptr, cache.Find(MakeKey(2)));
+    EXPECT_NE(nullptr, cache.Find(MakeKey(9)));
+}
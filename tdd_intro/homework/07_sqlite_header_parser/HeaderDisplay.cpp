@@ -0,0 +1,40 @@
+#include <exception>
+
+#include "HeaderDisplay.h"
+
+std::vector<std::string> FormatHeaderLines(const SqliteHeader& header)
+{
+    std::vector<std::string> messagesForOutput;
+    messagesForOutput.reserve(21);
+    messagesForOutput.push_back("Type - " + header.head);
+    messagesForOutput.push_back("DB page size - " + std::to_string(UnsignedHeaderField(header.pageSize)));
+    messagesForOutput.push_back("File format write version - " + std::to_string(UnsignedHeaderField(header.fileFormatWriteVersion)));
+    messagesForOutput.push_back("File format read version - " + std::to_string(UnsignedHeaderField(header.fileFormatReadVersion)));
+    messagesForOutput.push_back("Unused bytes - " + std::to_string(UnsignedHeaderField(header.bytesOfUnused)));
+    messagesForOutput.push_back("Maximum embedded payload fraction - " + std::to_string(UnsignedHeaderField(header.maximumEmbeddedPayloadFraction)));
+    messagesForOutput.push_back("Minimum embedded payload fraction - " + std::to_string(UnsignedHeaderField(header.minimumEmbeddedPayloadFraction)));
+    messagesForOutput.push_back("Leaf payload fraction - " + std::to_string(UnsignedHeaderField(header.leafPayloadFraction)));
+    messagesForOutput.push_back("File change counter - " + std::to_string(UnsignedHeaderField(header.fileChangeCounter)));
+    messagesForOutput.push_back("Size of the database file in pages - " + std::to_string(UnsignedHeaderField(header.pageCount)));
+    messagesForOutput.push_back("Page number of the first freelist trunk page - " + std::to_string(UnsignedHeaderField(header.firstFreelistPage)));
+    messagesForOutput.push_back("Total number of freelist pages - " + std::to_string(UnsignedHeaderField(header.freelistPageCount)));
+    messagesForOutput.push_back("The schema format number - " + std::to_string(UnsignedHeaderField(header.schemaFormat)));
+    messagesForOutput.push_back("Default page cache size - " + std::to_string(header.defaultPageCacheSize));
+    messagesForOutput.push_back("The page number of the largest root b-tree page - " + std::to_string(UnsignedHeaderField(header.numberOfLargestRootPage)));
+    messagesForOutput.push_back("The database text encoding - " + std::to_string(UnsignedHeaderField(header.databaseTextEncoding)));
+    messagesForOutput.push_back("The \"user version\" - " + std::to_string(header.userVersion));
+    messagesForOutput.push_back("The vacuum mode - " + std::to_string(UnsignedHeaderField(header.incrementalVacuumMode)));
+    messagesForOutput.push_back("The \"Application ID\" - " + std::to_string(header.applicationId));
+    messagesForOutput.push_back("The version-valid-for number - " + std::to_string(UnsignedHeaderField(header.versionValidNumber)));
+    messagesForOutput.push_back("The SQLITE_VERSION_NUMBER - " + std::to_string(UnsignedHeaderField(header.sqliteVersionNumber)));
+    return messagesForOutput;
+}
+
+void DysplayHeaderStructure(IGui* gui, IDbReader* dbReader)
+{
+    if (gui == nullptr || dbReader->IsEmpty() || !dbReader->CheckHeader())
+    {
+        throw std::exception();
+    }
+    gui->DisplayHeader(FormatHeaderLines(dbReader->ReadHeader()));
+}
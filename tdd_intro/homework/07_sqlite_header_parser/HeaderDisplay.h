@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Interfaces.h"
+
+// SqliteHeader keeps every field as int. The file stores them as unsigned numbers except the
+// default page cache size, the user version and the application id, which are signed 32-bit
+// numbers, so every other field is shown through this conversion.
+inline int64_t UnsignedHeaderField(int value)
+{
+    return static_cast<uint32_t>(value);
+}
+
+// One human readable "<description> - <value>" line per header field
+std::vector<std::string> FormatHeaderLines(const SqliteHeader& header);
+
+// Formats every header field of the database opened by dbReader and passes them to gui.
+// Throws std::exception when there is no gui or the reader holds no valid header.
+void DysplayHeaderStructure(IGui* gui, IDbReader* dbReader);
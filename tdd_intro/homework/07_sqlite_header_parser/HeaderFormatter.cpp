@@ -0,0 +1,236 @@
+#include <algorithm>
+#include <charconv>
+
+#include "HeaderFormatter.h"
+#include "HeaderDisplay.h"
+
+namespace
+{
+    struct HeaderField
+    {
+        const char* name;
+        int SqliteHeader::* value;
+        bool isSigned; // stored as a 32-bit two's complement number, the others are unsigned
+    };
+
+    // Numeric fields in file order, the names are used for JSON keys and CSV columns
+    const HeaderField g_headerFields[] = {
+        {"pageSize", &SqliteHeader::pageSize, false},
+        {"fileFormatWriteVersion", &SqliteHeader::fileFormatWriteVersion, false},
+        {"fileFormatReadVersion", &SqliteHeader::fileFormatReadVersion, false},
+        {"bytesOfUnused", &SqliteHeader::bytesOfUnused, false},
+        {"maximumEmbeddedPayloadFraction", &SqliteHeader::maximumEmbeddedPayloadFraction, false},
+        {"minimumEmbeddedPayloadFraction", &SqliteHeader::minimumEmbeddedPayloadFraction, false},
+        {"leafPayloadFraction", &SqliteHeader::leafPayloadFraction, false},
+        {"fileChangeCounter", &SqliteHeader::fileChangeCounter, false},
+        {"pageCount", &SqliteHeader::pageCount, false},
+        {"firstFreelistPage", &SqliteHeader::firstFreelistPage, false},
+        {"freelistPageCount", &SqliteHeader::freelistPageCount, false},
+        {"schemaFormat", &SqliteHeader::schemaFormat, false},
+        {"defaultPageCacheSize", &SqliteHeader::defaultPageCacheSize, true},
+        {"numberOfLargestRootPage", &SqliteHeader::numberOfLargestRootPage, false},
+        {"databaseTextEncoding", &SqliteHeader::databaseTextEncoding, false},
+        {"userVersion", &SqliteHeader::userVersion, true},
+        {"incrementalVacuumMode", &SqliteHeader::incrementalVacuumMode, false},
+        {"applicationId", &SqliteHeader::applicationId, true},
+        {"versionValidNumber", &SqliteHeader::versionValidNumber, false},
+        {"sqliteVersionNumber", &SqliteHeader::sqliteVersionNumber, false}};
+
+    // The same values FormatHeaderLines shows, 0xffffffff is -1 in a signed field
+    int64_t FieldValue(const SqliteHeader& header, const HeaderField& field)
+    {
+        const int value = header.*field.value;
+        return field.isSigned ? value : UnsignedHeaderField(value);
+    }
+
+    const size_t g_maxNumberLength = 20;
+}
+
+OutputBuffer::OutputBuffer(std::ostream& stream, size_t size)
+    : m_stream(stream)
+    , m_buffer(std::max<size_t>(size, g_maxNumberLength))
+    , m_used(0)
+{
+}
+
+OutputBuffer::~OutputBuffer()
+{
+    Flush();
+}
+
+void OutputBuffer::Reserve(size_t size)
+{
+    if (m_used + size > m_buffer.size())
+    {
+        Write();
+    }
+}
+
+void OutputBuffer::Write()
+{
+    if (m_used != 0)
+    {
+        m_stream.write(m_buffer.data(), static_cast<std::streamsize>(m_used));
+        m_used = 0;
+    }
+}
+
+void OutputBuffer::Append(char symbol)
+{
+    Reserve(1);
+    m_buffer[m_used++] = symbol;
+}
+
+void OutputBuffer::Append(std::string_view text)
+{
+    while (!text.empty())
+    {
+        Reserve(std::min(text.size(), m_buffer.size()));
+        const size_t part = std::min(text.size(), m_buffer.size() - m_used);
+        std::copy(text.begin(), text.begin() + part, m_buffer.begin() + m_used);
+        m_used += part;
+        text.remove_prefix(part);
+    }
+}
+
+void OutputBuffer::AppendNumber(uint64_t value)
+{
+    Reserve(g_maxNumberLength);
+    const std::to_chars_result result = std::to_chars(m_buffer.data() + m_used, m_buffer.data() + m_buffer.size(), value);
+    m_used = static_cast<size_t>(result.ptr - m_buffer.data());
+}
+
+void OutputBuffer::AppendNumber(int64_t value)
+{
+    Reserve(g_maxNumberLength);
+    const std::to_chars_result result = std::to_chars(m_buffer.data() + m_used, m_buffer.data() + m_buffer.size(), value);
+    m_used = static_cast<size_t>(result.ptr - m_buffer.data());
+}
+
+void OutputBuffer::AppendJsonString(std::string_view text, bool escapeHighBytes)
+{
+    const char* const hexDigits = "0123456789abcdef";
+    Append('"');
+    size_t plainBegin = 0;
+    for (size_t i = 0; i < text.size(); ++i)
+    {
+        const unsigned char symbol = static_cast<unsigned char>(text[i]);
+        if (symbol >= 0x20 && symbol != '"' && symbol != '\\' && (symbol < 0x80 || !escapeHighBytes))
+        {
+            continue;
+        }
+        Append(text.substr(plainBegin, i - plainBegin));
+        plainBegin = i + 1;
+        if (symbol == '"' || symbol == '\\')
+        {
+            const char escaped[] = {'\\', static_cast<char>(symbol)};
+            Append(std::string_view(escaped, 2));
+        }
+        else
+        {
+            const char escaped[] = {'\\', 'u', '0', '0', hexDigits[symbol >> 4], hexDigits[symbol & 0xf]};
+            Append(std::string_view(escaped, 6));
+        }
+    }
+    Append(text.substr(plainBegin));
+    Append('"');
+}
+
+void OutputBuffer::AppendCsvField(std::string_view text)
+{
+    if (text.find_first_of(",\"\r\n") == std::string_view::npos)
+    {
+        Append(text);
+        return;
+    }
+    Append('"');
+    for (size_t quote = text.find('"'); quote != std::string_view::npos; quote = text.find('"'))
+    {
+        Append(text.substr(0, quote + 1));
+        Append('"');
+        text.remove_prefix(quote + 1);
+    }
+    Append(text);
+    Append('"');
+}
+
+void OutputBuffer::Flush()
+{
+    Write();
+    m_stream.flush();
+}
+
+GuiHeaderFormatter::GuiHeaderFormatter(IGui* gui)
+    : m_gui(gui)
+{
+}
+
+void GuiHeaderFormatter::Format(const std::string& /*filePath*/, const SqliteHeader& header)
+{
+    m_gui->DisplayHeader(FormatHeaderLines(header));
+}
+
+void GuiHeaderFormatter::Flush()
+{
+}
+
+JsonLinesHeaderFormatter::JsonLinesHeaderFormatter(std::ostream& stream, size_t bufferSize)
+    : m_output(stream, bufferSize)
+{
+}
+
+void JsonLinesHeaderFormatter::Format(const std::string& filePath, const SqliteHeader& header)
+{
+    m_output.Append("{\"path\":");
+    m_output.AppendJsonString(filePath);
+    m_output.Append(",\"head\":");
+    m_output.AppendJsonString(header.head, true);
+    for (const HeaderField& field : g_headerFields)
+    {
+        m_output.Append(",\"");
+        m_output.Append(field.name);
+        m_output.Append("\":");
+        m_output.AppendNumber(FieldValue(header, field));
+    }
+    m_output.Append("}\n");
+}
+
+void JsonLinesHeaderFormatter::Flush()
+{
+    m_output.Flush();
+}
+
+CsvHeaderFormatter::CsvHeaderFormatter(std::ostream& stream, size_t bufferSize)
+    : m_output(stream, bufferSize)
+    , m_columnsWritten(false)
+{
+}
+
+void CsvHeaderFormatter::Format(const std::string& filePath, const SqliteHeader& header)
+{
+    if (!m_columnsWritten)
+    {
+        m_output.Append("path,head");
+        for (const HeaderField& field : g_headerFields)
+        {
+            m_output.Append(',');
+            m_output.Append(field.name);
+        }
+        m_output.Append('\n');
+        m_columnsWritten = true;
+    }
+    m_output.AppendCsvField(filePath);
+    m_output.Append(',');
+    m_output.AppendCsvField(header.head);
+    for (const HeaderField& field : g_headerFields)
+    {
+        m_output.Append(',');
+        m_output.AppendNumber(FieldValue(header, field));
+    }
+    m_output.Append('\n');
+}
+
+void CsvHeaderFormatter::Flush()
+{
+    m_output.Flush();
+}
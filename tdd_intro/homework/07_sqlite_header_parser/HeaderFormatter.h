@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+#include "Interfaces.h"
+
+const size_t g_defaultOutputBufferSize = 64 * 1024;
+
+// Fixed-size character buffer that is written to the stream only when it fills up or on Flush.
+// Only Flush and the destructor flush the stream itself.
+// Numbers are printed with std::to_chars straight into the buffer, nothing is allocated per value.
+class OutputBuffer
+{
+public:
+    explicit OutputBuffer(std::ostream& stream, size_t size = g_defaultOutputBufferSize);
+    ~OutputBuffer();
+    OutputBuffer(const OutputBuffer&) = delete;
+    OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+    void Append(char symbol);
+    void Append(std::string_view text);
+    void AppendNumber(uint64_t value);
+    void AppendNumber(int64_t value);
+    // Text in double quotes with the JSON escapes. Raw bytes that need not be UTF-8, like the
+    // header string, pass escapeHighBytes so bytes from 0x80 on become \u00XX too.
+    void AppendJsonString(std::string_view text, bool escapeHighBytes = false);
+    // Text quoted only when it holds a separator, a quote or a line break
+    void AppendCsvField(std::string_view text);
+    void Flush();
+
+private:
+    void Reserve(size_t size);
+    void Write();
+
+    std::ostream& m_stream;
+    std::vector<char> m_buffer;
+    size_t m_used;
+};
+
+// The human readable path, every header becomes one IGui::DisplayHeader call
+class GuiHeaderFormatter : public IHeaderFormatter
+{
+public:
+    explicit GuiHeaderFormatter(IGui* gui);
+    void Format(const std::string& filePath, const SqliteHeader& header);
+    void Flush();
+
+private:
+    IGui* m_gui;
+};
+
+// One JSON object per line: {"path":"...","head":"SQLite format 3","pageSize":4096,...}
+class JsonLinesHeaderFormatter : public IHeaderFormatter
+{
+public:
+    explicit JsonLinesHeaderFormatter(std::ostream& stream, size_t bufferSize = g_defaultOutputBufferSize);
+    void Format(const std::string& filePath, const SqliteHeader& header);
+    void Flush();
+
+private:
+    OutputBuffer m_output;
+};
+
+// A row per header under a column names row written before the first one
+class CsvHeaderFormatter : public IHeaderFormatter
+{
+public:
+    explicit CsvHeaderFormatter(std::ostream& stream, size_t bufferSize = g_defaultOutputBufferSize);
+    void Format(const std::string& filePath, const SqliteHeader& header);
+    void Flush();
+
+private:
+    OutputBuffer m_output;
+    bool m_columnsWritten;
+};
@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <sstream>
+
+#include "HeaderFormatter.h"
+#include "HeaderDisplay.h"
+#include "Mocks.h"
+
+using namespace testing;
+
+namespace
+{
+    SqliteHeader MakeHeader()
+    {
+        SqliteHeader header{"SQLite format 3", 4096, 2, 2, 0, 64, 32, 32, 7, 30, 0, 0,
+                            4, 0, 0, 1, 0, 0, 0, 7, 3040001};
+        header.defaultPageCacheSize = -2000; // the signed fields are written with a minus sign
+        header.userVersion = -2;
+        header.applicationId = -1; // 0xffffffff in the file
+        return header;
+    }
+
+    const char* const s_jsonFields =
+        "\"head\":\"SQLite format 3\",\"pageSize\":4096,\"fileFormatWriteVersion\":2,\"fileFormatReadVersion\":2,"
+        "\"bytesOfUnused\":0,\"maximumEmbeddedPayloadFraction\":64,\"minimumEmbeddedPayloadFraction\":32,"
+        "\"leafPayloadFraction\":32,\"fileChangeCounter\":7,\"pageCount\":30,\"firstFreelistPage\":0,"
+        "\"freelistPageCount\":0,\"schemaFormat\":4,\"defaultPageCacheSize\":-2000,\"numberOfLargestRootPage\":0,"
+        "\"databaseTextEncoding\":1,\"userVersion\":-2,\"incrementalVacuumMode\":0,\"applicationId\":-1,"
+        "\"versionValidNumber\":7,\"sqliteVersionNumber\":3040001}\n";
+
+    // Keeps the characters and counts how many times the stream was flushed
+    class CountingBuffer : public std::stringbuf
+    {
+    public:
+        int syncCount = 0;
+
+    protected:
+        int sync()
+        {
+            ++syncCount;
+            return std::stringbuf::sync();
+        }
+    };
+}
+
+TEST(HeaderFormatter, JsonLine)
+{
+    std::ostringstream stream;
+    JsonLinesHeaderFormatter formatter(stream);
+    formatter.Format("/data/a.db", MakeHeader());
+    formatter.Flush();
+    EXPECT_EQ(std::string("{\"path\":\"/data/a.db\",") + s_jsonFields, stream.str());
+}
+
+TEST(HeaderFormatter, JsonEscapes)
+{
+    std::ostringstream stream;
+    OutputBuffer output(stream);
+    output.AppendJsonString("a\"b\\c\nd\x01");
+    output.Flush();
+    EXPECT_EQ("\"a\\\"b\\\\c\\u000ad\\u0001\"", stream.str());
+}
+
+TEST(HeaderFormatter, HighBytesOfHeadAreEscaped)
+{
+    SqliteHeader header = MakeHeader();
+    header.head = "SQLite\xff\x80";
+    std::ostringstream stream;
+    JsonLinesHeaderFormatter formatter(stream);
+    formatter.Format("/data/\xc3\xa9.db", header);
+    formatter.Flush();
+    EXPECT_EQ(0u, stream.str().find("{\"path\":\"/data/\xc3\xa9.db\",\"head\":\"SQLite\\u00ff\\u0080\","));
+}
+
+TEST(HeaderFormatter, LargeUnsignedFieldSameAsText)
+{
+    SqliteHeader header = MakeHeader();
+    header.fileChangeCounter = -2; // 0xfffffffe in the file
+    const std::vector<std::string> lines = FormatHeaderLines(header);
+    EXPECT_NE(lines.end(), std::find(lines.begin(), lines.end(), "File change counter - 4294967294"));
+
+    std::ostringstream stream;
+    JsonLinesHeaderFormatter formatter(stream);
+    formatter.Format("a.db", header);
+    formatter.Flush();
+    EXPECT_NE(std::string::npos, stream.str().find(",\"fileChangeCounter\":4294967294,"));
+}
+
+TEST(HeaderFormatter, CsvRows)
+{
+    std::ostringstream stream;
+    CsvHeaderFormatter formatter(stream);
+    formatter.Format("a.db", MakeHeader());
+    formatter.Format("b,\"c\".db", MakeHeader());
+    formatter.Flush();
+
+    std::istringstream lines(stream.str());
+    std::string line;
+    std::getline(lines, line);
+    EXPECT_EQ(0u, line.find("path,head,pageSize,fileFormatWriteVersion,"));
+    EXPECT_NE(std::string::npos, line.find(",applicationId,versionValidNumber,sqliteVersionNumber"));
+    std::getline(lines, line);
+    EXPECT_EQ("a.db,SQLite format 3,4096,2,2,0,64,32,32,7,30,0,0,4,-2000,0,1,-2,0,-1,7,3040001", line);
+    std::getline(lines, line);
+    EXPECT_EQ(0u, line.find("\"b,\"\"c\"\".db\",SQLite format 3,4096,"));
+    EXPECT_FALSE(std::getline(lines, line));
+}
+
+TEST(HeaderFormatter, NothingWrittenBeforeBufferIsFull)
+{
+    std::ostringstream stream;
+    JsonLinesHeaderFormatter formatter(stream);
+    formatter.Format("a.db", MakeHeader());
+    EXPECT_TRUE(stream.str().empty());
+    formatter.Flush();
+    EXPECT_FALSE(stream.str().empty());
+}
+
+TEST(HeaderFormatter, TinyBufferGivesSameOutput)
+{
+    std::ostringstream large;
+    std::ostringstream tiny;
+    JsonLinesHeaderFormatter largeFormatter(large);
+    JsonLinesHeaderFormatter tinyFormatter(tiny, 1);
+    for (int i = 0; i < 100; ++i)
+    {
+        const std::string path = "/data/" + std::to_string(i) + ".db";
+        largeFormatter.Format(path, MakeHeader());
+        tinyFormatter.Format(path, MakeHeader());
+    }
+    largeFormatter.Flush();
+    tinyFormatter.Flush();
+    EXPECT_EQ(large.str(), tiny.str());
+}
+
+TEST(HeaderFormatter, StreamFlushedOnlyOnFlush)
+{
+    CountingBuffer buffer;
+    std::ostream stream(&buffer);
+    {
+        JsonLinesHeaderFormatter formatter(stream, 16);
+        for (int i = 0; i < 100; ++i)
+        {
+            formatter.Format("a.db", MakeHeader());
+        }
+        EXPECT_EQ(0, buffer.syncCount);
+        formatter.Flush();
+    }
+    EXPECT_EQ(2, buffer.syncCount); // Flush and the destructor
+    const std::string written = buffer.str();
+    EXPECT_EQ(100, std::count(written.begin(), written.end(), '\n'));
+}
+
+TEST(HeaderFormatter, GuiIsOneFormatter)
+{
+    GuiMock gui;
+    GuiHeaderFormatter formatter(&gui);
+    EXPECT_CALL(gui, DisplayHeader(AllOf(SizeIs(21), Contains("DB page size - 4096"),
+                                         Contains("The \"Application ID\" - -1"))));
+    formatter.Format("a.db", MakeHeader());
+}
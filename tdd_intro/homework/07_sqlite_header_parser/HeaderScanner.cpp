@@ -0,0 +1,290 @@
+#include <algorithm>
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+
+#include "HeaderScanner.h"
+#include "DbReader.h"
+#include "HeaderBatchReader.h"
+#include "HeaderCache.h"
+#include "HeaderValidator.h"
+
+namespace
+{
+    using PathBatch = std::vector<std::string>;
+
+    // Single producer, many consumers. Push blocks while the queue is full.
+    class BatchQueue
+    {
+    public:
+        explicit BatchQueue(size_t capacity)
+            : m_capacity(capacity)
+            , m_closed(false)
+        {
+        }
+
+        void Push(PathBatch&& batch)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_notFull.wait(lock, [this]{ return m_batches.size() < m_capacity; });
+            m_batches.push(std::move(batch));
+            m_notEmpty.notify_one();
+        }
+
+        // Returns false once the queue is closed and drained
+        bool Pop(PathBatch& batch)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_notEmpty.wait(lock, [this]{ return m_closed || !m_batches.empty(); });
+            if (m_batches.empty())
+            {
+                return false;
+            }
+            batch = std::move(m_batches.front());
+            m_batches.pop();
+            m_notFull.notify_one();
+            return true;
+        }
+
+        void Close()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_closed = true;
+            m_notEmpty.notify_all();
+        }
+
+    private:
+        const size_t m_capacity;
+        bool m_closed;
+        std::queue<PathBatch> m_batches;
+        std::mutex m_mutex;
+        std::condition_variable m_notFull;
+        std::condition_variable m_notEmpty;
+    };
+
+    using HeaderRows = std::vector<std::pair<std::string, SqliteHeader>>;
+
+    // reader holds the bytes just read from filePath, readOk is false when the read failed
+    void ScanFile(const std::string& filePath, bool readOk, DbReader& reader, ScanSummary& summary, HeaderRows* rows)
+    {
+        ++summary.filesVisited;
+        if (!readOk)
+        {
+            if (IsSqliteFileName(filePath))
+            {
+                summary.badHeaders.push_back(filePath + ": can not be read");
+            }
+            return;
+        }
+        if (!reader.CheckHeader())
+        {
+            if (IsSqliteFileName(filePath))
+            {
+                summary.badHeaders.push_back(filePath + (reader.IsEmpty() ? ": empty file" : ": no SQLite header"));
+            }
+            return;
+        }
+
+        ++summary.sqliteFiles;
+        const SqliteHeader header = reader.ReadHeader();
+        const uint32_t violations = reader.GetViolations();
+        if (violations != 0)
+        {
+            std::string problem = filePath;
+            const char* separator = ": ";
+            for (const std::string& message : DescribeViolations(violations))
+            {
+                problem += separator + message;
+                separator = ", ";
+            }
+            summary.badHeaders.push_back(problem);
+            return;
+        }
+        if (rows != nullptr)
+        {
+            rows->emplace_back(filePath, header);
+        }
+        ++summary.pageSizes[header.pageSize];
+        if (header.fileFormatWriteVersion == 2)
+        {
+            ++summary.walFiles;
+        }
+        else
+        {
+            ++summary.legacyFiles;
+        }
+    }
+
+    void Merge(ScanSummary& total, ScanSummary& part)
+    {
+        total.filesVisited += part.filesVisited;
+        total.sqliteFiles += part.sqliteFiles;
+        total.walFiles += part.walFiles;
+        total.legacyFiles += part.legacyFiles;
+        total.cacheHits += part.cacheHits;
+        for (const auto& pageSize : part.pageSizes)
+        {
+            total.pageSizes[pageSize.first] += pageSize.second;
+        }
+        std::move(part.badHeaders.begin(), part.badHeaders.end(), std::back_inserter(total.badHeaders));
+    }
+}
+
+bool IsSqliteFileName(const std::string& filePath)
+{
+    const std::string extension = std::filesystem::path(filePath).extension().string();
+    return extension == ".db" || extension == ".db3" || extension == ".sqlite" || extension == ".sqlite3";
+}
+
+HeaderScanner::HeaderScanner(size_t threads, size_t batchSize, bool useIoUring)
+    : m_threads(threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency()))
+    , m_batchSize(std::max<size_t>(1, batchSize))
+    , m_useIoUring(useIoUring)
+{
+}
+
+ScanSummary HeaderScanner::Scan(const std::string& root, IHeaderFormatter* formatter, HeaderCache* cache) const
+{
+    namespace fs = std::filesystem;
+    std::error_code error;
+    if (!fs::is_directory(root, error))
+    {
+        throw std::runtime_error("Not a directory: " + root);
+    }
+
+    // files modified after this may still change without changing their key, they are read
+    // but not cached
+    const int64_t cacheableBeforeNs = FileClockNowNs() - g_racyModificationNs;
+    BatchQueue queue(m_threads * 2);
+    std::vector<ScanSummary> parts(m_threads);
+    std::mutex formatterMutex;
+    std::vector<std::thread> workers;
+    workers.reserve(m_threads);
+    for (size_t i = 0; i < m_threads; ++i)
+    {
+        workers.emplace_back([this, &queue, &part = parts[i], formatter, &formatterMutex, cache, cacheableBeforeNs]()
+        {
+            HeaderBatchReader batchReader(m_useIoUring, static_cast<unsigned>(m_batchSize));
+            DbReader reader;
+            PathBatch batch;
+            PathBatch misses;
+            std::vector<FileKey> missKeys;
+            std::vector<char> missKeyed;
+            HeaderRows rows;
+            while (queue.Pop(batch))
+            {
+                HeaderRows* rowsOut = formatter != nullptr ? &rows : nullptr;
+                const PathBatch* toRead = &batch;
+                if (cache != nullptr)
+                {
+                    // files whose key is cached are decoded from the cache without being opened
+                    misses.clear();
+                    missKeys.clear();
+                    missKeyed.clear();
+                    for (std::string& filePath : batch)
+                    {
+                        FileKey key{};
+                        const bool keyed = GetFileKey(filePath, key);
+                        if (const HeaderCacheEntry* entry = keyed ? cache->Find(key) : nullptr)
+                        {
+                            ++part.cacheHits;
+                            const bool readOk = reader.ReadBytes(entry->bytes, entry->size);
+                            ScanFile(filePath, readOk, reader, part, rowsOut);
+                            continue;
+                        }
+                        misses.push_back(std::move(filePath));
+                        missKeys.push_back(key);
+                        missKeyed.push_back(keyed);
+                    }
+                    toRead = &misses;
+                }
+                batchReader.Read(*toRead, [&](size_t index, const unsigned char* bytes, int64_t size)
+                {
+                    if (cache != nullptr && size >= 0 && missKeyed[index] &&
+                        missKeys[index].modifiedNs < cacheableBeforeNs)
+                    {
+                        cache->Insert(missKeys[index], bytes, static_cast<size_t>(size));
+                    }
+                    const bool readOk = reader.ReadBytes(bytes, size);
+                    ScanFile((*toRead)[index], readOk, reader, part, rowsOut);
+                });
+                if (!rows.empty())
+                {
+                    std::lock_guard<std::mutex> lock(formatterMutex);
+                    for (const auto& row : rows)
+                    {
+                        formatter->Format(row.first, row.second);
+                    }
+                    rows.clear();
+                }
+            }
+        });
+    }
+
+    PathBatch batch;
+    batch.reserve(m_batchSize);
+    // Every directory gets its own iterator: a recursive iterator ends the whole walk on the
+    // first error, here only the directory that failed is recorded and skipped.
+    // Symbolic links to directories are not followed, like in a recursive iterator.
+    std::vector<std::string> walkErrors;
+    std::vector<fs::path> directories(1, fs::path(root));
+    const auto options = fs::directory_options::skip_permission_denied;
+    while (!directories.empty())
+    {
+        const fs::path directory = std::move(directories.back());
+        directories.pop_back();
+        fs::directory_iterator it(directory, options, error);
+        for (const fs::directory_iterator end; !error && it != end; it.increment(error))
+        {
+            std::error_code statusError;
+            if (it->is_directory(statusError) && !it->is_symlink(statusError))
+            {
+                directories.push_back(it->path());
+                continue;
+            }
+            if (!it->is_regular_file(statusError))
+            {
+                continue;
+            }
+            batch.push_back(it->path().string());
+            if (batch.size() == m_batchSize)
+            {
+                queue.Push(std::move(batch));
+                batch = PathBatch();
+                batch.reserve(m_batchSize);
+            }
+        }
+        if (error)
+        {
+            walkErrors.push_back(directory.string() + ": " + error.message());
+            error.clear();
+        }
+    }
+    if (!batch.empty())
+    {
+        queue.Push(std::move(batch));
+    }
+    queue.Close();
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+
+    if (formatter != nullptr)
+    {
+        formatter->Flush();
+    }
+
+    ScanSummary summary;
+    for (ScanSummary& part : parts)
+    {
+        Merge(summary, part);
+    }
+    std::sort(summary.badHeaders.begin(), summary.badHeaders.end());
+    std::sort(walkErrors.begin(), walkErrors.end());
+    summary.walkErrors = std::move(walkErrors);
+    return summary;
+}
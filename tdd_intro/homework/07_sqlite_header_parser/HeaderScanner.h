@@ -0,0 +1,46 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Interfaces.h"
+
+class HeaderCache;
+
+// Result of validating every database header found under a directory tree
+struct ScanSummary
+{
+    size_t filesVisited = 0;
+    size_t sqliteFiles = 0;
+    size_t walFiles = 0;
+    size_t legacyFiles = 0;
+    size_t cacheHits = 0; // files decoded from the HeaderCache without being opened
+    std::map<int, size_t> pageSizes; // page size -> number of databases
+    std::vector<std::string> badHeaders; // "path: reason", sorted by path
+    std::vector<std::string> walkErrors; // "directory: reason" of directories that could not be listed
+};
+
+// Extensions under which a file is expected to be a database even without the magic string
+bool IsSqliteFileName(const std::string& filePath);
+
+// Walks a directory tree and reads only the first 100 bytes of every regular file.
+// Paths are handed out in batches to a fixed pool of workers through a bounded queue,
+// so the walk never runs far ahead of the reads and memory stays flat on huge trees.
+// With useIoUring each worker reads its whole batch through a HeaderBatchReader ring,
+// where io_uring is unavailable the workers fall back to blocking reads.
+class HeaderScanner
+{
+public:
+    explicit HeaderScanner(size_t threads = 0, size_t batchSize = 256, bool useIoUring = true);
+    // Headers that pass the checks also go to formatter, a batch at a time under a lock.
+    // With a cache every file is looked up by one stat first and only the misses are read,
+    // the bytes read are inserted into the cache unless the file was modified less than
+    // g_racyModificationNs before the scan started. Saving the cache is up to the caller.
+    ScanSummary Scan(const std::string& root, IHeaderFormatter* formatter = nullptr, HeaderCache* cache = nullptr) const;
+
+private:
+    size_t m_threads;
+    size_t m_batchSize;
+    bool m_useIoUring;
+};
@@ -0,0 +1,292 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <filesystem>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "HeaderCache.h"
+#include "HeaderScanner.h"
+#include "Mocks.h"
+#include "TestFiles.h"
+
+using namespace test;
+
+namespace
+{
+    namespace fs = std::filesystem;
+
+    class ScanDirectory
+    {
+    public:
+        ScanDirectory()
+            : m_root(fs::temp_directory_path() / "header_scanner_test")
+        {
+            fs::remove_all(m_root);
+            fs::create_directories(m_root / "nested" / "deeper");
+        }
+
+        ~ScanDirectory()
+        {
+            std::error_code error;
+            fs::remove_all(m_root, error);
+        }
+
+        void Add(const std::string& relativePath, const std::vector<unsigned char>& bytes)
+        {
+            WriteTestFile((m_root / relativePath).string(), bytes);
+        }
+
+        // Moves the modification time of every file an hour back, out of the racy window
+        void Age()
+        {
+            const auto before = fs::file_time_type::clock::now() - std::chrono::hours(1);
+            for (const fs::directory_entry& entry : fs::recursive_directory_iterator(m_root))
+            {
+                if (entry.is_regular_file())
+                {
+                    fs::last_write_time(entry.path(), before);
+                }
+            }
+        }
+
+        std::string Root() const
+        {
+            return m_root.string();
+        }
+
+    private:
+        fs::path m_root;
+    };
+
+#ifndef _WIN32
+    // Nested directories whose full path is longer than PATH_MAX. They are made and removed
+    // through open directory descriptors, no call takes their full path.
+    class TooDeepDirectory
+    {
+    public:
+        explicit TooDeepDirectory(const std::string& parent)
+            : m_name(200, 'd')
+        {
+            m_descriptors.push_back(::open(parent.c_str(), O_RDONLY | O_DIRECTORY));
+            for (int level = 0; level < 25; ++level)
+            {
+                ::mkdirat(m_descriptors.back(), m_name.c_str(), 0700);
+                m_descriptors.push_back(::openat(m_descriptors.back(), m_name.c_str(), O_RDONLY | O_DIRECTORY));
+            }
+        }
+
+        ~TooDeepDirectory()
+        {
+            for (size_t level = m_descriptors.size() - 1; level > 0; --level)
+            {
+                ::close(m_descriptors[level]);
+                ::unlinkat(m_descriptors[level - 1], m_name.c_str(), AT_REMOVEDIR);
+            }
+            ::close(m_descriptors[0]);
+        }
+
+        const std::string& Name() const
+        {
+            return m_name;
+        }
+
+    private:
+        const std::string m_name;
+        std::vector<int> m_descriptors;
+    };
+#endif
+
+    std::vector<unsigned char> MakeWalHeaderBytes(uint16_t pageSize)
+    {
+        std::vector<unsigned char> bytes = MakeHeaderBytes();
+        WriteBigEndian16(bytes, 16, pageSize);
+        bytes[18] = 2;
+        bytes[19] = 2;
+        return bytes;
+    }
+
+    std::vector<unsigned char> MakeLegacyHeaderBytes(uint16_t pageSize)
+    {
+        std::vector<unsigned char> bytes = MakeWalHeaderBytes(pageSize);
+        bytes[18] = 1;
+        bytes[19] = 1;
+        return bytes;
+    }
+}
+
+TEST(HeaderScanner, RootNotExist)
+{
+    HeaderScanner scanner(2);
+    ASSERT_THROW(scanner.Scan("no_such_directory"), std::runtime_error);
+}
+
+TEST(HeaderScanner, EmptyDirectory)
+{
+    ScanDirectory directory;
+    const ScanSummary summary = HeaderScanner(2).Scan(directory.Root());
+    EXPECT_EQ(0u, summary.filesVisited);
+    EXPECT_EQ(0u, summary.sqliteFiles);
+    EXPECT_TRUE(summary.badHeaders.empty());
+}
+
+TEST(HeaderScanner, CountsModesAndPageSizes)
+{
+    ScanDirectory directory;
+    directory.Add("a.db", MakeWalHeaderBytes(4096));
+    directory.Add("nested/b.sqlite", MakeWalHeaderBytes(4096));
+    directory.Add("nested/deeper/c", MakeLegacyHeaderBytes(1024));
+    directory.Add("nested/deeper/d.sqlite3", MakeLegacyHeaderBytes(1));
+    directory.Add("readme.txt", {'h', 'i'});
+
+    const ScanSummary summary = HeaderScanner(2, 1).Scan(directory.Root());
+    EXPECT_EQ(5u, summary.filesVisited);
+    EXPECT_EQ(4u, summary.sqliteFiles);
+    EXPECT_EQ(2u, summary.walFiles);
+    EXPECT_EQ(2u, summary.legacyFiles);
+    const std::map<int, size_t> pageSizes{{1024, 1}, {4096, 2}, {65536, 1}};
+    EXPECT_EQ(pageSizes, summary.pageSizes);
+    EXPECT_TRUE(summary.badHeaders.empty());
+}
+
+TEST(HeaderScanner, ReportsBadHeaders)
+{
+    ScanDirectory directory;
+    std::vector<unsigned char> badPageSize = MakeWalHeaderBytes(1000);
+    std::vector<unsigned char> badFractions = MakeWalHeaderBytes(4096);
+    badFractions[21] = 10;
+    std::vector<unsigned char> truncated = MakeWalHeaderBytes(4096);
+    truncated.resize(50);
+    directory.Add("a.db", badPageSize);
+    directory.Add("b", badFractions);
+    directory.Add("c.sqlite", truncated);
+    directory.Add("d.db", {});
+    directory.Add("e.txt", truncated);
+
+    const ScanSummary summary = HeaderScanner(3, 2).Scan(directory.Root());
+    EXPECT_EQ(5u, summary.filesVisited);
+    EXPECT_EQ(2u, summary.sqliteFiles);
+    ASSERT_EQ(4u, summary.badHeaders.size());
+    EXPECT_NE(std::string::npos, summary.badHeaders[0].find("a.db: page size is not a power of two"));
+    EXPECT_NE(std::string::npos, summary.badHeaders[1].find("b: maximum embedded payload fraction is not 64"));
+    EXPECT_NE(std::string::npos, summary.badHeaders[2].find("c.sqlite: no SQLite header"));
+    EXPECT_NE(std::string::npos, summary.badHeaders[3].find("d.db: empty file"));
+}
+
+TEST(HeaderScanner, ManyFilesThroughSmallQueue)
+{
+    ScanDirectory directory;
+    for (int i = 0; i < 300; ++i)
+    {
+        directory.Add("nested/" + std::to_string(i) + ".db", MakeWalHeaderBytes(i % 2 ? 4096 : 8192));
+    }
+
+    const ScanSummary summary = HeaderScanner(4, 7).Scan(directory.Root());
+    EXPECT_EQ(300u, summary.sqliteFiles);
+    EXPECT_EQ(150u, summary.pageSizes.at(4096));
+    EXPECT_EQ(150u, summary.pageSizes.at(8192));
+}
+
+TEST(HeaderScanner, ValidHeadersGoToFormatter)
+{
+    ScanDirectory directory;
+    directory.Add("a.db", MakeWalHeaderBytes(4096));
+    directory.Add("nested/b.db", MakeLegacyHeaderBytes(1024));
+    directory.Add("nested/c.db", MakeWalHeaderBytes(1000));
+
+    testing::StrictMock<HeaderFormatterMock> formatter;
+    EXPECT_CALL(formatter, Format(testing::EndsWith("a.db"), testing::Field(&SqliteHeader::pageSize, 4096)));
+    EXPECT_CALL(formatter, Format(testing::EndsWith("b.db"), testing::Field(&SqliteHeader::pageSize, 1024)));
+    EXPECT_CALL(formatter, Flush());
+    HeaderScanner(2, 1).Scan(directory.Root(), &formatter);
+}
+
+TEST(HeaderScanner, BlockingReadsGiveSameSummary)
+{
+    ScanDirectory directory;
+    std::vector<unsigned char> truncated = MakeWalHeaderBytes(4096);
+    truncated.resize(50);
+    for (int i = 0; i < 40; ++i)
+    {
+        directory.Add("nested/" + std::to_string(i) + ".db", i % 5 ? MakeLegacyHeaderBytes(1024) : truncated);
+    }
+
+    const ScanSummary ring = HeaderScanner(2, 16, true).Scan(directory.Root());
+    const ScanSummary blocking = HeaderScanner(2, 16, false).Scan(directory.Root());
+    EXPECT_EQ(40u, ring.filesVisited);
+    EXPECT_EQ(32u, ring.legacyFiles);
+    EXPECT_EQ(blocking.filesVisited, ring.filesVisited);
+    EXPECT_EQ(blocking.sqliteFiles, ring.sqliteFiles);
+    EXPECT_EQ(blocking.pageSizes, ring.pageSizes);
+    EXPECT_EQ(blocking.badHeaders, ring.badHeaders);
+}
+
+TEST(HeaderScanner, UnchangedFilesComeFromCache)
+{
+    ScanDirectory directory;
+    const std::string cachePath = (fs::temp_directory_path() / "header_scanner_test.cache").string();
+    for (int i = 0; i < 20; ++i)
+    {
+        directory.Add("nested/" + std::to_string(i) + ".db", MakeWalHeaderBytes(4096));
+    }
+    directory.Add("readme.txt", {'h', 'i'});
+    directory.Age();
+
+    HeaderCache cache;
+    const ScanSummary first = HeaderScanner(2, 4).Scan(directory.Root(), nullptr, &cache);
+    EXPECT_EQ(0u, first.cacheHits);
+    cache.Save(cachePath);
+
+    std::vector<unsigned char> changed = MakeLegacyHeaderBytes(1024);
+    changed.push_back(0);
+    directory.Add("nested/3.db", changed);
+    ASSERT_TRUE(cache.Load(cachePath));
+    const ScanSummary second = HeaderScanner(2, 4).Scan(directory.Root(), nullptr, &cache);
+    std::remove(cachePath.c_str());
+
+    EXPECT_EQ(20u, second.cacheHits);
+    EXPECT_EQ(21u, second.filesVisited);
+    EXPECT_EQ(20u, second.sqliteFiles);
+    EXPECT_EQ(1u, second.legacyFiles);
+    EXPECT_EQ(1u, second.pageSizes.at(1024));
+    EXPECT_EQ(19u, second.pageSizes.at(4096));
+}
+
+TEST(HeaderScanner, JustModifiedFilesAreNotCached)
+{
+    ScanDirectory directory;
+    const std::string cachePath = (fs::temp_directory_path() / "header_scanner_test.cache").string();
+    directory.Add("old.db", MakeWalHeaderBytes(4096));
+    directory.Age();
+    directory.Add("new.db", MakeWalHeaderBytes(4096));
+
+    HeaderCache cache;
+    HeaderScanner(2, 4).Scan(directory.Root(), nullptr, &cache);
+    cache.Save(cachePath);
+    ASSERT_TRUE(cache.Load(cachePath));
+    std::remove(cachePath.c_str());
+
+    EXPECT_EQ(1u, cache.Size());
+    FileKey key;
+    ASSERT_TRUE(GetFileKey((fs::path(directory.Root()) / "old.db").string(), key));
+    EXPECT_NE(nullptr, cache.Find(key));
+}
+
+#ifndef _WIN32
+TEST(HeaderScanner, DirectoryThatCanNotBeListedIsReported)
+{
+    ScanDirectory directory;
+    directory.Add("a.db", MakeWalHeaderBytes(4096));
+    TooDeepDirectory deep((fs::path(directory.Root()) / "nested").string());
+    directory.Add("nested/" + deep.Name() + "/b.db", MakeWalHeaderBytes(4096));
+    directory.Add("nested/deeper/c.db", MakeWalHeaderBytes(4096));
+
+    const ScanSummary summary = HeaderScanner(2, 1).Scan(directory.Root());
+    EXPECT_EQ(3u, summary.sqliteFiles);
+    ASSERT_EQ(1u, summary.walkErrors.size());
+    EXPECT_EQ(0u, summary.walkErrors[0].find((fs::path(directory.Root()) / "nested" / deep.Name()).string()));
+}
+#endif
@@ -0,0 +1,115 @@
+#include <cstring>
+
+#include "HeaderValidator.h"
+#include "SqliteFormat.h"
+
+namespace
+{
+    const char* const g_violationMessages[g_headerViolationsCount] = {
+        "wrong header string",
+        "page size is not a power of two between 512 and 65536",
+        "file format write version is not 1 or 2",
+        "file format read version is not 1 or 2",
+        "reserved space leaves less than 480 usable bytes in a page",
+        "maximum embedded payload fraction is not 64",
+        "minimum embedded payload fraction is not 32",
+        "leaf payload fraction is not 32",
+        "freelist does not fit in the database",
+        "schema format is not 1 to 4",
+        "text encoding is not UTF-8, UTF-16le or UTF-16be",
+        "incremental vacuum without auto-vacuum",
+        "bytes reserved for expansion are not zero"};
+
+    inline uint32_t Bit(bool violated, HeaderViolation violation)
+    {
+        return static_cast<uint32_t>(violated) * violation;
+    }
+
+    inline uint64_t Load64(const unsigned char* bytes)
+    {
+        uint64_t value;
+        std::memcpy(&value, bytes, sizeof(value));
+        return value;
+    }
+}
+
+uint32_t ValidateHeader(const unsigned char* bytes)
+{
+    const bool magicOk = std::memcmp(bytes, g_sqliteMagic, g_sqliteMagicSize) == 0;
+
+    const uint32_t rawPageSize = ReadBigEndian16(bytes + 16);
+    const uint32_t pageSize = rawPageSize == 1 ? 65536u : rawPageSize;
+    const bool pageSizeOk = (rawPageSize == 1) |
+                            ((rawPageSize >= 512) & ((rawPageSize & (rawPageSize - 1)) == 0));
+    const bool writeVersionOk = static_cast<uint32_t>(bytes[18] - 1) < 2;
+    const bool readVersionOk = static_cast<uint32_t>(bytes[19] - 1) < 2;
+    const bool unusedBytesOk = pageSize >= bytes[20] + 480u;
+
+    const uint32_t changeCounter = ReadBigEndian32(bytes + 24);
+    const uint32_t pageCount = ReadBigEndian32(bytes + 28);
+    const uint32_t firstFreelistPage = ReadBigEndian32(bytes + 32);
+    const uint32_t freelistPageCount = ReadBigEndian32(bytes + 36);
+    const uint32_t schemaCookie = ReadBigEndian32(bytes + 40);
+    const uint32_t schemaFormat = ReadBigEndian32(bytes + 44);
+    const uint32_t largestRootPage = ReadBigEndian32(bytes + 52);
+    const uint32_t textEncoding = ReadBigEndian32(bytes + 56);
+    const uint32_t incrementalVacuum = ReadBigEndian32(bytes + 64);
+    const uint32_t versionValidNumber = ReadBigEndian32(bytes + 92);
+
+    // the page count is only maintained when the version-valid-for number matches the counter
+    const bool pageCountValid = (versionValidNumber == changeCounter) & (pageCount != 0);
+    const bool freelistFits = (freelistPageCount < pageCount) & (firstFreelistPage <= pageCount) &
+                              ((firstFreelistPage == 0) == (freelistPageCount == 0));
+    // a database without any schema yet has zeros in both fields
+    const bool noSchema = schemaCookie == 0;
+    const bool schemaFormatOk = (schemaFormat - 1 < 4) | (noSchema & (schemaFormat == 0));
+    const bool textEncodingOk = (textEncoding - 1 < 3) | (noSchema & (textEncoding == 0));
+    const bool reservedZero = (Load64(bytes + 72) | Load64(bytes + 80) | ReadBigEndian32(bytes + 88)) == 0;
+
+    return Bit(!magicOk, ViolationMagic) |
+           Bit(!pageSizeOk, ViolationPageSize) |
+           Bit(!writeVersionOk, ViolationWriteVersion) |
+           Bit(!readVersionOk, ViolationReadVersion) |
+           Bit(!unusedBytesOk, ViolationUnusedBytes) |
+           Bit(bytes[21] != 64, ViolationMaximumPayloadFraction) |
+           Bit(bytes[22] != 32, ViolationMinimumPayloadFraction) |
+           Bit(bytes[23] != 32, ViolationLeafPayloadFraction) |
+           Bit(pageCountValid & !freelistFits, ViolationFreelist) |
+           Bit(!schemaFormatOk, ViolationSchemaFormat) |
+           Bit(!textEncodingOk, ViolationTextEncoding) |
+           Bit((incrementalVacuum != 0) & (largestRootPage == 0), ViolationIncrementalVacuum) |
+           Bit(!reservedZero, ViolationReservedNotZero);
+}
+
+void ValidateHeaders(const unsigned char* headers, size_t count, uint32_t* violations)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        violations[i] = ValidateHeader(headers + i * g_sqliteHeaderSize);
+    }
+}
+
+const char* ViolationMessage(HeaderViolation violation)
+{
+    for (size_t bit = 0; bit < g_headerViolationsCount; ++bit)
+    {
+        if (violation == (1u << bit))
+        {
+            return g_violationMessages[bit];
+        }
+    }
+    return "unknown violation";
+}
+
+std::vector<std::string> DescribeViolations(uint32_t violations)
+{
+    std::vector<std::string> messages;
+    for (size_t bit = 0; bit < g_headerViolationsCount; ++bit)
+    {
+        if ((violations & (1u << bit)) != 0)
+        {
+            messages.push_back(g_violationMessages[bit]);
+        }
+    }
+    return messages;
+}
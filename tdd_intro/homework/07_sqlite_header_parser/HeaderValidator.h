@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Constraints of the file format spec a database header can violate, one bit each
+enum HeaderViolation : uint32_t
+{
+    ViolationMagic = 1u << 0,
+    ViolationPageSize = 1u << 1,
+    ViolationWriteVersion = 1u << 2,
+    ViolationReadVersion = 1u << 3,
+    ViolationUnusedBytes = 1u << 4,
+    ViolationMaximumPayloadFraction = 1u << 5,
+    ViolationMinimumPayloadFraction = 1u << 6,
+    ViolationLeafPayloadFraction = 1u << 7,
+    ViolationFreelist = 1u << 8,
+    ViolationSchemaFormat = 1u << 9,
+    ViolationTextEncoding = 1u << 10,
+    ViolationIncrementalVacuum = 1u << 11,
+    ViolationReservedNotZero = 1u << 12
+};
+
+const size_t g_headerViolationsCount = 13;
+
+// Checks every rule on the raw 100 header bytes and returns the bitmask of the broken ones.
+// All rules are evaluated without early exits or data dependent branches, so the cost is
+// the same for any input.
+uint32_t ValidateHeader(const unsigned char* bytes);
+
+// Validates count headers stored one after another, 100 bytes each
+void ValidateHeaders(const unsigned char* headers, size_t count, uint32_t* violations);
+
+// Message for a single violation bit
+const char* ViolationMessage(HeaderViolation violation);
+
+// Messages for every bit set in violations, in bit order
+std::vector<std::string> DescribeViolations(uint32_t violations);
@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+
+#include "HeaderValidator.h"
+#include "TestFiles.h"
+
+using namespace test;
+
+TEST(HeaderValidator, ValidHeader)
+{
+    EXPECT_EQ(0u, ValidateHeader(MakeHeaderBytes().data()));
+}
+
+TEST(HeaderValidator, WrongMagic)
+{
+    std::vector<unsigned char> bytes = MakeHeaderBytes();
+    bytes[15] = ' ';
+    EXPECT_EQ(ViolationMagic, ValidateHeader(bytes.data()));
+}
+
+TEST(HeaderValidator, PageSizes)
+{
+    std::vector<unsigned char> bytes = MakeHeaderBytes();
+    for (uint16_t pageSize : {512, 1024, 32768, 1})
+    {
+        WriteBigEndian16(bytes, 16, pageSize);
+        EXPECT_EQ(0u, ValidateHeader(bytes.data())) << pageSize;
+    }
+    for (uint16_t pageSize : {0, 2, 256, 1000, 4097})
+    {
+        WriteBigEndian16(bytes, 16, pageSize);
+        EXPECT_TRUE(ValidateHeader(bytes.data()) & ViolationPageSize) << pageSize;
+    }
+}
+
+TEST(HeaderValidator, FormatVersions)
+{
+    std::vector<unsigned char> bytes = MakeHeaderBytes();
+    bytes[18] = 0;
+    bytes[19] = 3;
+    EXPECT_EQ(ViolationWriteVersion | ViolationReadVersion, ValidateHeader(bytes.data()));
+}
+
+TEST(HeaderValidator, UnusedBytesLeaveTooLittleSpace)
+{
+    std::vector<unsigned char> bytes = MakeHeaderBytes();
+    WriteBigEndian16(bytes, 16, 512);
+    bytes[20] = 32;
+    EXPECT_EQ(0u, ValidateHeader(bytes.data()));
+    bytes[20] = 33;
+    EXPECT_EQ(ViolationUnusedBytes, ValidateHeader(bytes.data()));
+}
+
+TEST(HeaderValidator, PayloadFractions)
+{
+    std::vector<unsigned char> bytes = MakeHeaderBytes();
+    bytes[21] = 32;
+    bytes[22] = 64;
+    bytes[23] = 0;
+    EXPECT_EQ(ViolationMaximumPayloadFraction | ViolationMinimumPayloadFraction | ViolationLeafPayloadFraction,
+              ValidateHeader(bytes.data()));
+}
+
+TEST(HeaderValidator, FreelistLargerThanDatabase)
+{
+    std::vector<unsigned char> bytes = MakeHeaderBytes();
+    WriteBigEndian32(bytes, 36, 30);
+    EXPECT_EQ(ViolationFreelist, ValidateHeader(bytes.data()));
+
+    WriteBigEndian32(bytes, 92, 1); // page count is not maintained, nothing to compare with
+    EXPECT_EQ(0u, ValidateHeader(bytes.data()));
+}
+
+TEST(HeaderValidator, FreelistWithoutTrunk)
+{
+    std::vector<unsigned char> bytes = MakeHeaderBytes();
+    WriteBigEndian32(bytes, 32, 0);
+    EXPECT_EQ(ViolationFreelist, ValidateHeader(bytes.data()));
+}
+
+TEST(HeaderValidator, SchemaFormatAndEncoding)
+{
+    std::vector<unsigned char> bytes = MakeHeaderBytes();
+    WriteBigEndian32(bytes, 44, 5);
+    WriteBigEndian32(bytes, 56, 4);
+    EXPECT_EQ(ViolationSchemaFormat | ViolationTextEncoding, ValidateHeader(bytes.data()));
+
+    WriteBigEndian32(bytes, 44, 0);
+    WriteBigEndian32(bytes, 56, 0);
+    EXPECT_EQ(ViolationSchemaFormat | ViolationTextEncoding, ValidateHeader(bytes.data()));
+
+    WriteBigEndian32(bytes, 40, 0); // no schema has been written yet
+    EXPECT_EQ(0u, ValidateHeader(bytes.data()));
+}
+
+TEST(HeaderValidator, IncrementalVacuumNeedsAutoVacuum)
+{
+    std::vector<unsigned char> bytes = MakeHeaderBytes();
+    WriteBigEndian32(bytes, 52, 0);
+    EXPECT_EQ(ViolationIncrementalVacuum, ValidateHeader(bytes.data()));
+}
+
+TEST(HeaderValidator, ReservedBytesNotZero)
+{
+    for (size_t offset = 72; offset < 92; ++offset)
+    {
+        std::vector<unsigned char> bytes = MakeHeaderBytes();
+        bytes[offset] = 1;
+        EXPECT_EQ(ViolationReservedNotZero, ValidateHeader(bytes.data())) << offset;
+    }
+}
+
+TEST(HeaderValidator, ReportAllViolationsAtOnce)
+{
+    std::vector<unsigned char> bytes(g_sqliteHeaderSize, 0xff);
+    const uint32_t violations = ValidateHeader(bytes.data());
+    // a 65535 byte page has room for 255 reserved bytes and the largest root page is set
+    const uint32_t satisfied = ViolationUnusedBytes | ViolationIncrementalVacuum;
+    EXPECT_EQ(((1u << g_headerViolationsCount) - 1) & ~satisfied, violations);
+    EXPECT_EQ(g_headerViolationsCount - 2, DescribeViolations(violations).size());
+}
+
+TEST(HeaderValidator, Messages)
+{
+    const std::vector<std::string> messages = DescribeViolations(ViolationPageSize | ViolationReservedNotZero);
+    ASSERT_EQ(2u, messages.size());
+    EXPECT_EQ("page size is not a power of two between 512 and 65536", messages[0]);
+    EXPECT_EQ("bytes reserved for expansion are not zero", messages[1]);
+    EXPECT_STREQ("schema format is not 1 to 4", ViolationMessage(ViolationSchemaFormat));
+}
+
+TEST(HeaderValidator, ValidateMany)
+{
+    std::vector<unsigned char> headers = MakeHeaderBytes();
+    std::vector<unsigned char> broken = MakeHeaderBytes();
+    broken[21] = 0;
+    headers.insert(headers.end(), broken.begin(), broken.end());
+    uint32_t violations[2] = {1, 1};
+    ValidateHeaders(headers.data(), 2, violations);
+    EXPECT_EQ(0u, violations[0]);
+    EXPECT_EQ(ViolationMaximumPayloadFraction, violations[1]);
+}
@@ -0,0 +1,216 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include "HeaderWatcher.h"
+#include "SqliteFormat.h"
+
+namespace
+{
+    const size_t g_countersOffset = 24;
+    const size_t g_countersSize = 96 - g_countersOffset;
+    const size_t g_versionValidOffset = 92 - g_countersOffset;
+}
+
+HeaderWatcher::HeaderWatcher(bool useInotify)
+    : m_inotify(-1)
+{
+#ifdef __linux__
+    if (useInotify)
+    {
+        m_inotify = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    }
+#else
+    (void)useInotify;
+#endif
+}
+
+HeaderWatcher::~HeaderWatcher()
+{
+#ifdef __linux__
+    if (m_inotify != -1)
+    {
+        ::close(m_inotify);
+    }
+#endif
+}
+
+bool HeaderWatcher::Add(const std::string& filePath)
+{
+    if (m_files.count(filePath) != 0)
+    {
+        return true;
+    }
+    std::unique_ptr<WatchedFile> watched(new WatchedFile());
+    watched->path = filePath;
+    watched->watch = -1;
+    watched->dirty = false;
+    unsigned char magic[g_sqliteMagicSize];
+    if (!watched->file.Open(filePath) ||
+        watched->file.ReadAt(magic, sizeof(magic), 0) != static_cast<int64_t>(sizeof(magic)) ||
+        std::memcmp(magic, g_sqliteMagic, g_sqliteMagicSize) != 0 ||
+        !ReadCounters(*watched, watched->changeCounter, watched->versionValidNumber))
+    {
+        return false;
+    }
+#ifdef __linux__
+    if (m_inotify != -1)
+    {
+        watched->watch = ::inotify_add_watch(m_inotify, filePath.c_str(), IN_MODIFY | IN_ATTRIB | IN_DELETE_SELF);
+        if (watched->watch != -1)
+        {
+            m_watches[watched->watch].push_back(watched.get());
+        }
+    }
+#endif
+    m_files.emplace(filePath, std::move(watched));
+    return true;
+}
+
+void HeaderWatcher::Remove(const std::string& filePath)
+{
+    auto found = m_files.find(filePath);
+    if (found == m_files.end())
+    {
+        return;
+    }
+#ifdef __linux__
+    const int watch = found->second->watch;
+    if (watch != -1)
+    {
+        std::vector<WatchedFile*>& sharing = m_watches[watch];
+        sharing.erase(std::find(sharing.begin(), sharing.end(), found->second.get()));
+        if (sharing.empty())
+        {
+            ::inotify_rm_watch(m_inotify, watch);
+            m_watches.erase(watch);
+        }
+    }
+#endif
+    m_files.erase(found);
+}
+
+size_t HeaderWatcher::Size() const
+{
+    return m_files.size();
+}
+
+bool HeaderWatcher::UsesInotify() const
+{
+    return m_inotify != -1;
+}
+
+bool HeaderWatcher::ReadCounters(WatchedFile& watched, uint32_t& changeCounter, uint32_t& versionValidNumber) const
+{
+    unsigned char bytes[g_countersSize];
+    if (watched.file.ReadAt(bytes, sizeof(bytes), g_countersOffset) != static_cast<int64_t>(sizeof(bytes)))
+    {
+        return false;
+    }
+    changeCounter = ReadBigEndian32(bytes);
+    versionValidNumber = ReadBigEndian32(bytes + g_versionValidOffset);
+    return true;
+}
+
+void HeaderWatcher::DrainEvents()
+{
+#ifdef __linux__
+    alignas(struct inotify_event) char buffer[4096];
+    while (true)
+    {
+        const ssize_t length = ::read(m_inotify, buffer, sizeof(buffer));
+        if (length <= 0)
+        {
+            break;
+        }
+        for (ssize_t offset = 0; offset < length; )
+        {
+            const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(buffer + offset);
+            offset += sizeof(struct inotify_event) + event->len;
+            if ((event->mask & IN_Q_OVERFLOW) != 0)
+            {
+                // events were lost, any file may have been written
+                for (auto& entry : m_files)
+                {
+                    entry.second->dirty = true;
+                }
+                continue;
+            }
+            auto sharing = m_watches.find(event->wd);
+            if (sharing == m_watches.end())
+            {
+                continue;
+            }
+            const bool watchLost = (event->mask & (IN_IGNORED | IN_DELETE_SELF)) != 0;
+            for (WatchedFile* watched : sharing->second)
+            {
+                watched->dirty = true;
+                if (watchLost)
+                {
+                    watched->watch = -1; // polled on every call from now on
+                }
+            }
+            if (watchLost)
+            {
+                m_watches.erase(sharing);
+            }
+        }
+    }
+#endif
+}
+
+size_t HeaderWatcher::Poll(const HeaderChangeCallback& callback)
+{
+    if (UsesInotify())
+    {
+        DrainEvents();
+    }
+    size_t changes = 0;
+    for (auto& entry : m_files)
+    {
+        WatchedFile& watched = *entry.second;
+        // files without a watch could not be registered and are always reread
+        if (UsesInotify() && watched.watch != -1 && !watched.dirty)
+        {
+            continue;
+        }
+        watched.dirty = false;
+        uint32_t changeCounter = 0;
+        uint32_t versionValidNumber = 0;
+        if (!ReadCounters(watched, changeCounter, versionValidNumber))
+        {
+            continue; // truncated while being rewritten, try again on the next poll
+        }
+        if (changeCounter == watched.changeCounter && versionValidNumber == watched.versionValidNumber)
+        {
+            continue;
+        }
+        const HeaderChange change{watched.path, watched.changeCounter, changeCounter, versionValidNumber};
+        watched.changeCounter = changeCounter;
+        watched.versionValidNumber = versionValidNumber;
+        ++changes;
+        callback(change);
+    }
+    return changes;
+}
+
+size_t HeaderWatcher::Wait(const HeaderChangeCallback& callback, int timeoutMs)
+{
+#ifdef __linux__
+    if (UsesInotify())
+    {
+        struct pollfd descriptor{m_inotify, POLLIN, 0};
+        ::poll(&descriptor, 1, timeoutMs);
+        return Poll(callback);
+    }
+#endif
+    std::this_thread::sleep_for(std::chrono::milliseconds(timeoutMs));
+    return Poll(callback);
+}
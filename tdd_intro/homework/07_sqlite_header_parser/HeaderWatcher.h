@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "FileIo.h"
+
+struct HeaderChange
+{
+    std::string filePath;
+    uint32_t oldChangeCounter;
+    uint32_t newChangeCounter;
+    uint32_t versionValidNumber;
+};
+
+using HeaderChangeCallback = std::function<void(const HeaderChange&)>;
+
+// Keeps database files open and reports which of them were modified by watching the file
+// change counter (offset 24) and the version-valid-for number (offset 92). Both come from
+// one pread of bytes [24, 96), the rest of the file is never touched.
+// On Linux inotify tells which files were written so only those are reread, elsewhere
+// every file is reread on each poll. A lost event queue marks every file for a reread, a file
+// whose watch is gone (deleted, unmounted) is reread on every poll. In WAL mode the counter
+// changes at checkpoints only.
+class HeaderWatcher
+{
+public:
+    explicit HeaderWatcher(bool useInotify = true);
+    ~HeaderWatcher();
+    HeaderWatcher(const HeaderWatcher&) = delete;
+    HeaderWatcher& operator=(const HeaderWatcher&) = delete;
+
+    // Opens the file and remembers its current counters, false when it is not a database
+    bool Add(const std::string& filePath);
+    void Remove(const std::string& filePath);
+    size_t Size() const;
+    bool UsesInotify() const;
+
+    // Rereads the counters that may have changed and calls callback for every file whose
+    // counters differ from the last read. Returns the number of reported changes.
+    size_t Poll(const HeaderChangeCallback& callback);
+    // Waits up to timeoutMs for a write to a watched file, then polls
+    size_t Wait(const HeaderChangeCallback& callback, int timeoutMs);
+
+private:
+    struct WatchedFile
+    {
+        std::string path;
+        File file;
+        uint32_t changeCounter;
+        uint32_t versionValidNumber;
+        int watch;
+        bool dirty;
+    };
+
+    bool ReadCounters(WatchedFile& watched, uint32_t& changeCounter, uint32_t& versionValidNumber) const;
+    void DrainEvents();
+
+    int m_inotify;
+    std::unordered_map<std::string, std::unique_ptr<WatchedFile>> m_files;
+    std::unordered_map<int, std::vector<WatchedFile*>> m_watches; // hard links share a watch
+};
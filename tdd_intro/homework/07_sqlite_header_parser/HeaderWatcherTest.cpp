@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+
+#include "HeaderWatcher.h"
+#include "TestFiles.h"
+
+using namespace test;
+
+namespace
+{
+    const char* const s_firstFile = "watcher_first_test.db";
+    const char* const s_secondFile = "watcher_second_test.db";
+
+    class TestDatabases
+    {
+    public:
+        TestDatabases()
+        {
+            WriteTestFile(s_firstFile, MakeDatabaseBytes(512, 2));
+            WriteTestFile(s_secondFile, MakeDatabaseBytes(512, 2));
+        }
+
+        ~TestDatabases()
+        {
+            std::remove(s_firstFile);
+            std::remove(s_secondFile);
+        }
+    };
+
+    void OverwriteBigEndian32(const char* filePath, size_t offset, uint32_t value)
+    {
+        std::vector<unsigned char> bytes(4);
+        WriteBigEndian32(bytes, 0, value);
+        std::fstream file(filePath, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(offset);
+        file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    }
+
+    class HeaderWatcherTest : public testing::TestWithParam<bool>
+    {
+    protected:
+        HeaderWatcherTest()
+            : m_watcher(GetParam())
+        {
+        }
+
+        size_t Poll()
+        {
+            return m_watcher.Poll([this](const HeaderChange& change){ m_changes.push_back(change); });
+        }
+
+        TestDatabases m_databases;
+        HeaderWatcher m_watcher;
+        std::vector<HeaderChange> m_changes;
+    };
+}
+
+TEST_P(HeaderWatcherTest, AddOnlyDatabases)
+{
+    WriteTestFile("watcher_text_test.txt", {'t', 'e', 'x', 't'});
+    EXPECT_FALSE(m_watcher.Add("no_such_file.db"));
+    EXPECT_FALSE(m_watcher.Add("watcher_text_test.txt"));
+    EXPECT_TRUE(m_watcher.Add(s_firstFile));
+    EXPECT_EQ(1u, m_watcher.Size());
+    std::remove("watcher_text_test.txt");
+}
+
+TEST_P(HeaderWatcherTest, NoChangesNoEvents)
+{
+    ASSERT_TRUE(m_watcher.Add(s_firstFile));
+    ASSERT_TRUE(m_watcher.Add(s_secondFile));
+    EXPECT_EQ(0u, Poll());
+    EXPECT_TRUE(m_changes.empty());
+}
+
+TEST_P(HeaderWatcherTest, ReportChangedCounter)
+{
+    ASSERT_TRUE(m_watcher.Add(s_firstFile));
+    ASSERT_TRUE(m_watcher.Add(s_secondFile));
+    OverwriteBigEndian32(s_secondFile, 24, 0x01020305);
+
+    ASSERT_EQ(1u, Poll());
+    EXPECT_EQ(s_secondFile, m_changes[0].filePath);
+    EXPECT_EQ(0x01020304u, m_changes[0].oldChangeCounter);
+    EXPECT_EQ(0x01020305u, m_changes[0].newChangeCounter);
+    EXPECT_EQ(0u, Poll());
+}
+
+TEST_P(HeaderWatcherTest, ReportChangedVersionValidNumber)
+{
+    ASSERT_TRUE(m_watcher.Add(s_firstFile));
+    OverwriteBigEndian32(s_firstFile, 92, 7);
+
+    ASSERT_EQ(1u, Poll());
+    EXPECT_EQ(7u, m_changes[0].versionValidNumber);
+    EXPECT_EQ(m_changes[0].oldChangeCounter, m_changes[0].newChangeCounter);
+}
+
+TEST_P(HeaderWatcherTest, IgnoreOtherWrites)
+{
+    ASSERT_TRUE(m_watcher.Add(s_firstFile));
+    OverwriteBigEndian32(s_firstFile, 60, 42);
+    OverwriteBigEndian32(s_firstFile, 600, 42);
+    EXPECT_EQ(0u, Poll());
+}
+
+TEST_P(HeaderWatcherTest, RemovedFileIsNotReported)
+{
+    ASSERT_TRUE(m_watcher.Add(s_firstFile));
+    m_watcher.Remove(s_firstFile);
+    OverwriteBigEndian32(s_firstFile, 24, 1);
+    EXPECT_EQ(0u, m_watcher.Size());
+    EXPECT_EQ(0u, Poll());
+}
+
+TEST_P(HeaderWatcherTest, ChangeAfterEventQueueOverflow)
+{
+    const char* const thirdFile = "watcher_third_test.db";
+    WriteTestFile(thirdFile, MakeDatabaseBytes(512, 2));
+    ASSERT_TRUE(m_watcher.Add(s_firstFile));
+    ASSERT_TRUE(m_watcher.Add(s_secondFile));
+    ASSERT_TRUE(m_watcher.Add(thirdFile));
+
+    // alternating writes are not merged and overflow the default queue of 16384 events
+    std::fstream first(s_firstFile, std::ios::binary | std::ios::in | std::ios::out);
+    std::fstream second(s_secondFile, std::ios::binary | std::ios::in | std::ios::out);
+    for (int i = 0; i < 9000; ++i)
+    {
+        first.seekp(600);
+        first.put('a').flush();
+        second.seekp(600);
+        second.put('b').flush();
+    }
+    OverwriteBigEndian32(thirdFile, 24, 1);
+
+    EXPECT_EQ(1u, Poll());
+    std::remove(thirdFile);
+    ASSERT_EQ(1u, m_changes.size());
+    EXPECT_EQ(thirdFile, m_changes[0].filePath);
+}
+
+TEST_P(HeaderWatcherTest, WaitForChange)
+{
+    ASSERT_TRUE(m_watcher.Add(s_firstFile));
+    OverwriteBigEndian32(s_firstFile, 24, 1);
+    EXPECT_EQ(1u, m_watcher.Wait([](const HeaderChange&){}, 10));
+    EXPECT_EQ(0u, m_watcher.Wait([](const HeaderChange&){}, 10));
+}
+
+INSTANTIATE_TEST_CASE_P(PollOrInotify, HeaderWatcherTest, testing::Bool());
@@ -37,6 +37,15 @@ public:
     virtual void DisplayHeader(const std::vector<std::string>& header) = 0;
 };
 
+// Receives the headers of many databases and writes them out in some format
+class IHeaderFormatter
+{
+public:
+    virtual ~IHeaderFormatter(){}
+    virtual void Format(const std::string& filePath, const SqliteHeader& header) = 0;
+    virtual void Flush() = 0;
+};
+
 class IDbReader
 {
 public:
@@ -67,4 +76,5 @@ public:
     virtual int GetVersionValidNumber() = 0;
     virtual int GetSqliteVersionNumber() = 0;
     virtual bool IsEmpty() = 0;
+    virtual SqliteHeader ReadHeader() = 0; // all fields at once, prefer it over the getters
 };
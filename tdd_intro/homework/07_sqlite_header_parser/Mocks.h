@@ -11,6 +11,14 @@ public:
     MOCK_METHOD1(DisplayHeader, void(const std::vector<std::string>& header));
 };
 
+class HeaderFormatterMock: public IHeaderFormatter
+{
+public:
+    ~HeaderFormatterMock(){}
+    MOCK_METHOD2(Format, void(const std::string& filePath, const SqliteHeader& header));
+    MOCK_METHOD0(Flush, void());
+};
+
 class DbReaderMock: public IDbReader
 {
 public:
@@ -41,4 +49,5 @@ public:
     MOCK_METHOD0(GetVersionValidNumber, int());
     MOCK_METHOD0(GetSqliteVersionNumber, int());
     MOCK_METHOD0(IsEmpty, bool());
+    MOCK_METHOD0(ReadHeader, SqliteHeader());
 };
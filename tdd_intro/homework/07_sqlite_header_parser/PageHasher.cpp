@@ -0,0 +1,182 @@
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <thread>
+
+#include "PageHasher.h"
+#include "DbReader.h"
+#include "FileIo.h"
+#include "Xxh64.h"
+
+namespace
+{
+    const char g_manifestMagic[4] = {'S', 'Q', 'P', 'H'};
+    const uint32_t g_manifestVersion = 1;
+    const size_t g_readAlignment = 4096;
+
+    void AppendLittleEndian(std::vector<unsigned char>& bytes, uint64_t value, size_t size)
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            bytes.push_back(static_cast<unsigned char>(value >> (8 * i)));
+        }
+    }
+
+    uint64_t ReadLittleEndian(const unsigned char* bytes, size_t size)
+    {
+        uint64_t value = 0;
+        for (size_t i = size; i > 0; --i)
+        {
+            value = (value << 8) | bytes[i - 1];
+        }
+        return value;
+    }
+
+    struct AlignedBufferDeleter
+    {
+        void operator()(unsigned char* buffer) const
+        {
+            ::operator delete(buffer, std::align_val_t(g_readAlignment));
+        }
+    };
+}
+
+PageManifest HashPages(const std::string& filePath, size_t threads, size_t chunkBytes)
+{
+    File file;
+    if (!file.Open(filePath))
+    {
+        throw std::runtime_error("Can not open " + filePath);
+    }
+    const SqliteHeader header = ReadDatabaseHeader(file, filePath);
+    const int64_t fileSize = file.Size();
+    if (fileSize < 0)
+    {
+        throw std::runtime_error("Can not read " + filePath);
+    }
+
+    PageManifest manifest;
+    manifest.pageSize = static_cast<uint32_t>(header.pageSize);
+    const uint64_t pageCount = (static_cast<uint64_t>(fileSize) + manifest.pageSize - 1) / manifest.pageSize;
+    manifest.pageHashes.resize(pageCount);
+
+    const uint64_t pagesInChunk = std::max<uint64_t>(1, chunkBytes / manifest.pageSize);
+    const uint64_t chunkCount = (pageCount + pagesInChunk - 1) / pagesInChunk;
+    threads = threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<size_t>(std::min<uint64_t>(threads, std::max<uint64_t>(1, chunkCount)));
+#ifdef _WIN32
+    threads = 1; // File::ReadAt seeks a shared position there
+#endif
+
+    std::atomic<uint64_t> nextChunk(0);
+    std::exception_ptr failure;
+    std::mutex failureMutex;
+    auto hashChunks = [&]()
+    {
+        try
+        {
+            const size_t bufferSize = static_cast<size_t>(pagesInChunk * manifest.pageSize);
+            std::unique_ptr<unsigned char, AlignedBufferDeleter> buffer(
+                static_cast<unsigned char*>(::operator new(bufferSize, std::align_val_t(g_readAlignment))));
+            for (uint64_t chunk = nextChunk++; chunk < chunkCount; chunk = nextChunk++)
+            {
+                const uint64_t firstPage = chunk * pagesInChunk;
+                const int64_t bytesRead = file.ReadAt(buffer.get(), bufferSize, firstPage * manifest.pageSize);
+                if (bytesRead < 0)
+                {
+                    throw std::runtime_error("Can not read " + filePath);
+                }
+                for (uint64_t offset = 0; offset < static_cast<uint64_t>(bytesRead); offset += manifest.pageSize)
+                {
+                    const size_t size = static_cast<size_t>(std::min<uint64_t>(manifest.pageSize, bytesRead - offset));
+                    manifest.pageHashes[firstPage + offset / manifest.pageSize] = Xxh64(buffer.get() + offset, size);
+                }
+            }
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(failureMutex);
+            failure = std::current_exception();
+            nextChunk = chunkCount; // stop the other workers
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < threads; ++i)
+    {
+        workers.emplace_back(hashChunks);
+    }
+    hashChunks();
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+    if (failure)
+    {
+        std::rethrow_exception(failure);
+    }
+    return manifest;
+}
+
+void WritePageManifest(const std::string& manifestPath, const PageManifest& manifest)
+{
+    std::vector<unsigned char> bytes(g_manifestMagic, g_manifestMagic + sizeof(g_manifestMagic));
+    bytes.reserve(16 + 8 * manifest.pageHashes.size());
+    AppendLittleEndian(bytes, g_manifestVersion, 4);
+    AppendLittleEndian(bytes, manifest.pageSize, 4);
+    AppendLittleEndian(bytes, manifest.pageHashes.size(), 4);
+    for (uint64_t hash : manifest.pageHashes)
+    {
+        AppendLittleEndian(bytes, hash, 8);
+    }
+    std::ofstream file(manifestPath, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    if (!file)
+    {
+        throw std::runtime_error("Can not write " + manifestPath);
+    }
+}
+
+PageManifest ReadPageManifest(const std::string& manifestPath)
+{
+    std::ifstream file(manifestPath, std::ios::binary);
+    std::vector<unsigned char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (!file.is_open() || bytes.size() < 16 ||
+        !std::equal(g_manifestMagic, g_manifestMagic + sizeof(g_manifestMagic), bytes.begin()) ||
+        ReadLittleEndian(bytes.data() + 4, 4) != g_manifestVersion)
+    {
+        throw std::runtime_error("Not a page manifest: " + manifestPath);
+    }
+    PageManifest manifest;
+    manifest.pageSize = static_cast<uint32_t>(ReadLittleEndian(bytes.data() + 8, 4));
+    const uint64_t pageCount = ReadLittleEndian(bytes.data() + 12, 4);
+    if (bytes.size() != 16 + 8 * pageCount)
+    {
+        throw std::runtime_error("Truncated page manifest: " + manifestPath);
+    }
+    manifest.pageHashes.resize(pageCount);
+    for (uint64_t i = 0; i < pageCount; ++i)
+    {
+        manifest.pageHashes[i] = ReadLittleEndian(bytes.data() + 16 + 8 * i, 8);
+    }
+    return manifest;
+}
+
+std::vector<uint32_t> DiffManifests(const PageManifest& before, const PageManifest& after)
+{
+    std::vector<uint32_t> changedPages;
+    const bool samePageSize = before.pageSize == after.pageSize;
+    for (size_t i = 0; i < after.pageHashes.size(); ++i)
+    {
+        if (!samePageSize || i >= before.pageHashes.size() || before.pageHashes[i] != after.pageHashes[i])
+        {
+            changedPages.push_back(static_cast<uint32_t>(i + 1));
+        }
+    }
+    return changedPages;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+const size_t g_defaultHashChunkBytes = 8 * 1024 * 1024;
+
+// XXH64 of every page of a database file, pageHashes[0] is page 1
+struct PageManifest
+{
+    uint32_t pageSize = 0;
+    std::vector<uint64_t> pageHashes;
+};
+
+// Hashes the pages of a database file with a pool of threads. Each thread takes the next
+// chunk of about chunkBytes whole pages and reads it with one positional read into its own
+// page-aligned buffer. A torn last page is hashed as far as it goes.
+// Throws std::runtime_error when the file can not be read or has no valid header.
+PageManifest HashPages(const std::string& filePath, size_t threads = 0, size_t chunkBytes = g_defaultHashChunkBytes);
+
+// Manifest file: "SQPH", format version, page size, page count, then 8 bytes per page,
+// all little-endian. Throws std::runtime_error on I/O errors or a malformed manifest.
+void WritePageManifest(const std::string& manifestPath, const PageManifest& manifest);
+PageManifest ReadPageManifest(const std::string& manifestPath);
+
+// Pages of after that are new or differ from before, every page when the page size changed.
+// Pages dropped by a truncation show up as a smaller page count of after.
+std::vector<uint32_t> DiffManifests(const PageManifest& before, const PageManifest& after);
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstring>
+
+#include "PageHasher.h"
+#include "Xxh64.h"
+#include "TestFiles.h"
+
+using namespace test;
+
+namespace
+{
+    const char* const s_testFile = "pagehasher_test.db";
+    const char* const s_manifestFile = "pagehasher_test.manifest";
+    const uint16_t s_pageSize = 512;
+
+    class TestDatabase
+    {
+    public:
+        explicit TestDatabase(const std::vector<unsigned char>& bytes)
+        {
+            WriteTestFile(s_testFile, bytes);
+        }
+
+        ~TestDatabase()
+        {
+            std::remove(s_testFile);
+            std::remove(s_manifestFile);
+        }
+    };
+}
+
+TEST(Xxh64, ReferenceValues)
+{
+    const char* const sentence = "Nobody inspects the spammish repetition";
+    EXPECT_EQ(0xef46db3751d8e999ull, Xxh64("", 0));
+    EXPECT_EQ(0xd24ec4f1a98c6e5bull, Xxh64("a", 1));
+    EXPECT_EQ(0x44bc2cf5ad770999ull, Xxh64("abc", 3));
+    EXPECT_EQ(0xfbcea83c8a378bf1ull, Xxh64(sentence, std::strlen(sentence)));
+}
+
+TEST(PageHasher, FileNotExist)
+{
+    ASSERT_THROW(HashPages("no_such_file.db"), std::runtime_error);
+}
+
+TEST(PageHasher, HashEveryPage)
+{
+    const std::vector<unsigned char> bytes = MakeDatabaseBytes(s_pageSize, 5);
+    TestDatabase database(bytes);
+    const PageManifest manifest = HashPages(s_testFile, 2);
+
+    EXPECT_EQ(s_pageSize, manifest.pageSize);
+    ASSERT_EQ(5u, manifest.pageHashes.size());
+    for (size_t page = 0; page < 5; ++page)
+    {
+        EXPECT_EQ(Xxh64(bytes.data() + page * s_pageSize, s_pageSize), manifest.pageHashes[page]);
+    }
+}
+
+TEST(PageHasher, ChunksAndThreadsGiveSameManifest)
+{
+    std::vector<unsigned char> bytes = MakeDatabaseBytes(s_pageSize, 37);
+    bytes.resize(bytes.size() - 100); // torn last page
+    TestDatabase database(bytes);
+    const PageManifest single = HashPages(s_testFile, 1);
+    const PageManifest parallel = HashPages(s_testFile, 4, 3 * s_pageSize);
+
+    EXPECT_EQ(37u, single.pageHashes.size());
+    EXPECT_EQ(single.pageHashes, parallel.pageHashes);
+    EXPECT_EQ(Xxh64(bytes.data() + 36 * s_pageSize, s_pageSize - 100), single.pageHashes[36]);
+}
+
+TEST(PageHasher, ManifestRoundTrip)
+{
+    TestDatabase database(MakeDatabaseBytes(s_pageSize, 4));
+    const PageManifest written = HashPages(s_testFile);
+    WritePageManifest(s_manifestFile, written);
+    const PageManifest read = ReadPageManifest(s_manifestFile);
+
+    EXPECT_EQ(written.pageSize, read.pageSize);
+    EXPECT_EQ(written.pageHashes, read.pageHashes);
+}
+
+TEST(PageHasher, ReadMalformedManifest)
+{
+    TestDatabase database({'S', 'Q', 'P', 'H', 1, 0, 0, 0, 0, 2, 0, 0, 9, 0, 0, 0});
+    ASSERT_THROW(ReadPageManifest("no_such_file.manifest"), std::runtime_error);
+    ASSERT_THROW(ReadPageManifest(s_testFile), std::runtime_error); // 9 pages announced, none present
+}
+
+TEST(PageHasher, DiffChangedPages)
+{
+    std::vector<unsigned char> bytes = MakeDatabaseBytes(s_pageSize, 6);
+    TestDatabase database(bytes);
+    const PageManifest before = HashPages(s_testFile);
+
+    bytes[2 * s_pageSize + 10] ^= 1;
+    bytes[5 * s_pageSize] ^= 1;
+    std::vector<unsigned char> newPage(s_pageSize, 0x42);
+    bytes.insert(bytes.end(), newPage.begin(), newPage.end());
+    WriteTestFile(s_testFile, bytes);
+    const PageManifest after = HashPages(s_testFile);
+
+    EXPECT_EQ(std::vector<uint32_t>({3, 6, 7}), DiffManifests(before, after));
+    EXPECT_TRUE(DiffManifests(after, after).empty());
+}
+
+TEST(PageHasher, DiffDifferentPageSize)
+{
+    PageManifest before;
+    before.pageSize = 1024;
+    before.pageHashes = {1, 2};
+    PageManifest after = before;
+    after.pageSize = 512;
+    EXPECT_EQ(std::vector<uint32_t>({1, 2}), DiffManifests(before, after));
+}
@@ -0,0 +1,179 @@
+#include <algorithm>
+#include <new>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+
+#include "PageReader.h"
+#include "DbReader.h"
+
+namespace
+{
+    const size_t g_bufferAlignment = 4096;
+
+    std::align_val_t BufferAlignment(uint32_t pageSize)
+    {
+        return std::align_val_t(std::max<size_t>(pageSize, g_bufferAlignment));
+    }
+}
+
+PageReader::PageReader(const std::string& filePath, size_t capacity, uint64_t mmapLimit)
+    : m_header()
+    , m_pageSize(0)
+    , m_pageCount(0)
+    , m_capacity(std::max<size_t>(1, capacity))
+    , m_mapping(nullptr)
+    , m_mappingSize(0)
+    , m_buffers(nullptr)
+{
+    if (!m_file.Open(filePath))
+    {
+        throw std::runtime_error("Can not open " + filePath);
+    }
+    m_header = ReadDatabaseHeader(m_file, filePath);
+    m_pageSize = static_cast<uint32_t>(m_header.pageSize);
+
+    const int64_t fileSize = m_file.Size();
+    const uint32_t pagesInFile = fileSize > 0 ? static_cast<uint32_t>(fileSize / m_pageSize) : 0;
+    // the in-header size is only trusted when it was written by a version that maintains it
+    const bool headerPageCountValid = m_header.pageCount != 0 &&
+                                      m_header.versionValidNumber == m_header.fileChangeCounter;
+    m_pageCount = headerPageCountValid ? std::min(static_cast<uint32_t>(m_header.pageCount), pagesInFile)
+                                       : pagesInFile;
+
+    if (fileSize > 0 && static_cast<uint64_t>(fileSize) <= mmapLimit)
+    {
+        MapFile(static_cast<uint64_t>(fileSize));
+    }
+    if (m_mapping == nullptr)
+    {
+        m_buffers = static_cast<unsigned char*>(::operator new(m_capacity * m_pageSize, BufferAlignment(m_pageSize)));
+        m_freeBuffers.reserve(m_capacity);
+        for (size_t i = m_capacity; i > 0; --i)
+        {
+            m_freeBuffers.push_back(m_buffers + (i - 1) * m_pageSize);
+        }
+        m_cachedPages.reserve(m_capacity);
+    }
+}
+
+PageReader::~PageReader()
+{
+#ifndef _WIN32
+    if (m_mapping != nullptr)
+    {
+        ::munmap(m_mapping, m_mappingSize);
+    }
+#endif
+    if (m_buffers != nullptr)
+    {
+        ::operator delete(m_buffers, BufferAlignment(m_pageSize));
+    }
+}
+
+void PageReader::MapFile(uint64_t fileSize)
+{
+#ifdef _WIN32
+    (void)fileSize; // pread path only
+#else
+    void* mapping = ::mmap(nullptr, fileSize, PROT_READ, MAP_SHARED, m_file.Descriptor(), 0);
+    if (mapping != MAP_FAILED)
+    {
+        m_mapping = static_cast<unsigned char*>(mapping);
+        m_mappingSize = fileSize;
+        m_mappedPagesTouched.assign(static_cast<size_t>(m_pageCount) + 1, false);
+    }
+#endif
+}
+
+const SqliteHeader& PageReader::Header() const
+{
+    return m_header;
+}
+
+uint32_t PageReader::PageSize() const
+{
+    return m_pageSize;
+}
+
+uint32_t PageReader::PageCount() const
+{
+    return m_pageCount;
+}
+
+bool PageReader::IsMapped() const
+{
+    return m_mapping != nullptr;
+}
+
+const PageCacheCounters& PageReader::Counters() const
+{
+    return m_counters;
+}
+
+const unsigned char* PageReader::ReadPage(uint32_t pageNumber)
+{
+    if (pageNumber == 0 || pageNumber > m_pageCount)
+    {
+        throw std::runtime_error("Page " + std::to_string(pageNumber) + " is out of range");
+    }
+    const uint64_t offset = static_cast<uint64_t>(pageNumber - 1) * m_pageSize;
+    if (m_mapping != nullptr)
+    {
+        // touching a page the file no longer holds raises SIGBUS instead of an error
+        if (static_cast<int64_t>(offset + m_pageSize) > m_file.Size())
+        {
+            throw std::runtime_error("Page " + std::to_string(pageNumber) + " is past the end of the file");
+        }
+        if (m_mappedPagesTouched[pageNumber])
+        {
+            ++m_counters.hits;
+        }
+        else
+        {
+            m_mappedPagesTouched[pageNumber] = true;
+            ++m_counters.misses;
+            m_counters.bytesRead += m_pageSize;
+        }
+        return m_mapping + offset;
+    }
+
+    auto cached = m_cachedPages.find(pageNumber);
+    if (cached != m_cachedPages.end())
+    {
+        ++m_counters.hits;
+        m_recentPages.splice(m_recentPages.begin(), m_recentPages, cached->second.position);
+        return cached->second.buffer;
+    }
+
+    ++m_counters.misses;
+    unsigned char* buffer = TakeBuffer();
+    const int64_t bytesRead = m_file.ReadAt(buffer, m_pageSize, offset);
+    if (bytesRead != static_cast<int64_t>(m_pageSize))
+    {
+        m_freeBuffers.push_back(buffer);
+        throw std::runtime_error("Can not read page " + std::to_string(pageNumber));
+    }
+    m_counters.bytesRead += m_pageSize;
+    m_recentPages.push_front(pageNumber);
+    m_cachedPages.emplace(pageNumber, CachedPage{m_recentPages.begin(), buffer});
+    return buffer;
+}
+
+unsigned char* PageReader::TakeBuffer()
+{
+    if (!m_freeBuffers.empty())
+    {
+        unsigned char* buffer = m_freeBuffers.back();
+        m_freeBuffers.pop_back();
+        return buffer;
+    }
+    const uint32_t leastRecent = m_recentPages.back();
+    m_recentPages.pop_back();
+    auto evicted = m_cachedPages.find(leastRecent);
+    unsigned char* buffer = evicted->second.buffer;
+    m_cachedPages.erase(evicted);
+    return buffer;
+}
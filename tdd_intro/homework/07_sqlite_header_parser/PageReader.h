@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Interfaces.h"
+#include "FileIo.h"
+
+const size_t g_defaultPageCacheCapacity = 64;
+const uint64_t g_defaultMmapLimit = 256ull * 1024 * 1024;
+
+struct PageCacheCounters
+{
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t bytesRead = 0;
+
+    double HitRate() const
+    {
+        const uint64_t total = hits + misses;
+        return total == 0 ? 0.0 : static_cast<double>(hits) / total;
+    }
+};
+
+// Serves pages of a database file by number, starting with 1 like the file format does.
+// Files not larger than mmapLimit are mapped whole, the first access to a page counts as a miss
+// of PageSize() bytes read and later ones as hits. Larger files are read with pread into a fixed
+// number of page-aligned buffers recycled in LRU order.
+// The mapping is not safe on a file other processes write to: every access checks the file size
+// first, but a truncate between that check and the access still ends the program with SIGBUS.
+// Pass mmapLimit 0 for such files.
+// Throws std::runtime_error when the file can not be opened or has no valid header.
+class PageReader
+{
+public:
+    explicit PageReader(const std::string& filePath,
+                        size_t capacity = g_defaultPageCacheCapacity,
+                        uint64_t mmapLimit = g_defaultMmapLimit);
+    ~PageReader();
+    PageReader(const PageReader&) = delete;
+    PageReader& operator=(const PageReader&) = delete;
+
+    const SqliteHeader& Header() const;
+    uint32_t PageSize() const;
+    // In-header page count when it is valid, otherwise derived from the file size
+    uint32_t PageCount() const;
+    bool IsMapped() const;
+    const PageCacheCounters& Counters() const;
+
+    // Returns PageSize() bytes, valid until capacity other pages have been read.
+    // The header of page 1 is included. Throws std::runtime_error for pages out of range.
+    const unsigned char* ReadPage(uint32_t pageNumber);
+
+private:
+    struct CachedPage
+    {
+        std::list<uint32_t>::iterator position;
+        unsigned char* buffer;
+    };
+
+    void MapFile(uint64_t fileSize);
+    unsigned char* TakeBuffer();
+
+    File m_file;
+    SqliteHeader m_header;
+    uint32_t m_pageSize;
+    uint32_t m_pageCount;
+    size_t m_capacity;
+    unsigned char* m_mapping;
+    uint64_t m_mappingSize;
+    unsigned char* m_buffers; // m_capacity page-aligned pages
+    std::vector<unsigned char*> m_freeBuffers;
+    std::list<uint32_t> m_recentPages; // most recently used first
+    std::unordered_map<uint32_t, CachedPage> m_cachedPages;
+    std::vector<bool> m_mappedPagesTouched; // by page number, only in mmap mode
+    PageCacheCounters m_counters;
+};
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstring>
+
+#include "PageReader.h"
+#include "TestFiles.h"
+
+using namespace test;
+
+namespace
+{
+    const char* const s_testFile = "pagereader_test.db";
+
+    class TestDatabase
+    {
+    public:
+        explicit TestDatabase(const std::vector<unsigned char>& bytes)
+        {
+            WriteTestFile(s_testFile, bytes);
+        }
+
+        ~TestDatabase()
+        {
+            std::remove(s_testFile);
+        }
+    };
+
+    bool IsFilledWith(const unsigned char* page, size_t size, unsigned char value)
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            if (page[i] != value)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+TEST(PageReader, FileNotExist)
+{
+    ASSERT_THROW(PageReader("no_such_file.db"), std::runtime_error);
+}
+
+TEST(PageReader, NoSqliteHeader)
+{
+    TestDatabase database({'n', 'o', 't'});
+    ASSERT_THROW(PageReader reader(s_testFile), std::runtime_error);
+}
+
+TEST(PageReader, ReadPagesWithPread)
+{
+    TestDatabase database(MakeDatabaseBytes(1024, 5));
+    PageReader reader(s_testFile, 4, 0);
+    ASSERT_FALSE(reader.IsMapped());
+    ASSERT_EQ(1024u, reader.PageSize());
+    ASSERT_EQ(5u, reader.PageCount());
+
+    const unsigned char* firstPage = reader.ReadPage(1);
+    EXPECT_EQ(0, std::memcmp(firstPage, g_sqliteMagic, g_sqliteMagicSize));
+    EXPECT_TRUE(IsFilledWith(firstPage + g_sqliteHeaderSize, 1024 - g_sqliteHeaderSize, 1));
+    EXPECT_TRUE(IsFilledWith(reader.ReadPage(3), 1024, 3));
+    EXPECT_TRUE(IsFilledWith(reader.ReadPage(3), 1024, 3));
+
+    EXPECT_EQ(1u, reader.Counters().hits);
+    EXPECT_EQ(2u, reader.Counters().misses);
+    EXPECT_EQ(2048u, reader.Counters().bytesRead);
+}
+
+TEST(PageReader, BuffersArePageAligned)
+{
+    TestDatabase database(MakeDatabaseBytes(512, 4));
+    PageReader reader(s_testFile, 3, 0);
+    for (uint32_t page = 1; page <= 4; ++page)
+    {
+        EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(reader.ReadPage(page)) % 512);
+    }
+}
+
+TEST(PageReader, EvictLeastRecentlyUsed)
+{
+    TestDatabase database(MakeDatabaseBytes(512, 4));
+    PageReader reader(s_testFile, 2, 0);
+    reader.ReadPage(1);
+    reader.ReadPage(2);
+    reader.ReadPage(1); // page 2 becomes the oldest
+    EXPECT_TRUE(IsFilledWith(reader.ReadPage(3), 512, 3));
+    EXPECT_EQ(1u, reader.Counters().hits);
+
+    reader.ReadPage(1);
+    EXPECT_EQ(2u, reader.Counters().hits);
+    EXPECT_TRUE(IsFilledWith(reader.ReadPage(2), 512, 2));
+    EXPECT_EQ(4u, reader.Counters().misses);
+    EXPECT_DOUBLE_EQ(2.0 / 6.0, reader.Counters().HitRate());
+}
+
+TEST(PageReader, MapSmallFile)
+{
+    TestDatabase database(MakeDatabaseBytes(4096, 3));
+    PageReader reader(s_testFile);
+    ASSERT_TRUE(reader.IsMapped());
+    EXPECT_TRUE(IsFilledWith(reader.ReadPage(2), 4096, 2));
+    EXPECT_TRUE(IsFilledWith(reader.ReadPage(3), 4096, 3));
+    EXPECT_TRUE(IsFilledWith(reader.ReadPage(2), 4096, 2));
+    EXPECT_EQ(1u, reader.Counters().hits);
+    EXPECT_EQ(2u, reader.Counters().misses);
+    EXPECT_EQ(8192u, reader.Counters().bytesRead);
+}
+
+TEST(PageReader, MappedFileTruncated)
+{
+    TestDatabase database(MakeDatabaseBytes(4096, 3));
+    PageReader reader(s_testFile);
+    ASSERT_TRUE(reader.IsMapped());
+    WriteTestFile(s_testFile, MakeDatabaseBytes(4096, 1));
+    EXPECT_TRUE(IsFilledWith(reader.ReadPage(1) + 100, 4096 - 100, 1));
+    ASSERT_THROW(reader.ReadPage(3), std::runtime_error);
+}
+
+TEST(PageReader, PageOutOfRange)
+{
+    TestDatabase database(MakeDatabaseBytes(512, 2));
+    PageReader reader(s_testFile, 2, 0);
+    ASSERT_THROW(reader.ReadPage(0), std::runtime_error);
+    ASSERT_THROW(reader.ReadPage(3), std::runtime_error);
+}
+
+TEST(PageReader, StaleInHeaderPageCount)
+{
+    std::vector<unsigned char> bytes = MakeDatabaseBytes(512, 3);
+    WriteBigEndian32(bytes, 28, 100);
+    WriteBigEndian32(bytes, 92, 0); // written by an old library that did not maintain the size
+    TestDatabase database(bytes);
+    PageReader reader(s_testFile);
+    ASSERT_EQ(3u, reader.PageCount());
+}
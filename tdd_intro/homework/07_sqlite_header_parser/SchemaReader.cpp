@@ -0,0 +1,219 @@
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "SchemaReader.h"
+#include "SqliteFormat.h"
+
+namespace
+{
+    const size_t g_schemaColumns = 5;
+
+    void ThrowMalformed(uint32_t pageNumber)
+    {
+        throw std::runtime_error("Malformed schema page " + std::to_string(pageNumber));
+    }
+
+    size_t HeaderOffset(uint32_t pageNumber)
+    {
+        return pageNumber == 1 ? g_sqliteHeaderSize : 0;
+    }
+
+    // Size in bytes of a record value with the given serial type
+    uint64_t SerialTypeSize(uint64_t serialType)
+    {
+        static const uint64_t s_integerSizes[] = {0, 1, 2, 3, 4, 6, 8, 8, 0, 0};
+        if (serialType < 10)
+        {
+            return s_integerSizes[serialType];
+        }
+        return serialType >= 12 ? (serialType - 12) / 2 : 0;
+    }
+
+    int64_t ReadInteger(const unsigned char* bytes, uint64_t serialType)
+    {
+        if (serialType == 8 || serialType == 9)
+        {
+            return static_cast<int64_t>(serialType - 8);
+        }
+        const uint64_t size = SerialTypeSize(serialType);
+        uint64_t value = size != 0 && (bytes[0] & 0x80) != 0 ? ~0ull : 0; // sign extension
+        for (uint64_t i = 0; i < size; ++i)
+        {
+            value = (value << 8) | bytes[i];
+        }
+        return static_cast<int64_t>(value);
+    }
+
+    // Decodes the five sqlite_master columns, false when the record is malformed
+    bool DecodeSchemaRecord(const unsigned char* record, uint64_t size, SchemaRow& row)
+    {
+        const unsigned char* end = record + size;
+        uint64_t headerSize = 0;
+        const size_t headerSizeLength = ReadVarint(record, end, headerSize);
+        if (headerSizeLength == 0 || headerSize > size)
+        {
+            return false;
+        }
+        const unsigned char* type = record + headerSizeLength;
+        const unsigned char* typesEnd = record + headerSize;
+        const unsigned char* value = typesEnd;
+        std::string_view* const textColumns[g_schemaColumns] = {&row.type, &row.name, &row.tableName, nullptr, &row.sql};
+        row = SchemaRow{{}, {}, {}, 0, {}};
+        for (size_t column = 0; column < g_schemaColumns && type < typesEnd; ++column)
+        {
+            uint64_t serialType = 0;
+            const size_t typeLength = ReadVarint(type, typesEnd, serialType);
+            const uint64_t valueSize = SerialTypeSize(serialType);
+            if (typeLength == 0 || valueSize > static_cast<uint64_t>(end - value))
+            {
+                return false;
+            }
+            if (column == 3)
+            {
+                row.rootPage = serialType < 10 && serialType != 7 ? ReadInteger(value, serialType) : 0;
+            }
+            else if (serialType >= 13 && serialType % 2 == 1)
+            {
+                *textColumns[column] = std::string_view(reinterpret_cast<const char*>(value), valueSize);
+            }
+            type += typeLength;
+            value += valueSize;
+        }
+        return true;
+    }
+}
+
+SchemaReader::SchemaReader(PageReader& reader)
+    : m_reader(reader)
+    , m_usableSize(reader.PageSize() - static_cast<uint32_t>(reader.Header().bytesOfUnused))
+{
+}
+
+void SchemaReader::Visit(const SchemaVisitor& visitor)
+{
+    // page numbers are kept instead of page pointers, reading a child may evict its parent
+    m_pendingPages.assign(1, 1);
+    uint32_t pagesVisited = 0;
+    while (!m_pendingPages.empty())
+    {
+        const uint32_t pageNumber = m_pendingPages.back();
+        m_pendingPages.pop_back();
+        if (++pagesVisited > m_reader.PageCount())
+        {
+            ThrowMalformed(pageNumber); // a loop in the tree
+        }
+        const unsigned char* page = m_reader.ReadPage(pageNumber);
+        const unsigned char* header = page + HeaderOffset(pageNumber);
+        if (header[0] == g_leafTablePage)
+        {
+            VisitLeaf(pageNumber, visitor);
+            continue;
+        }
+        if (header[0] != g_interiorTablePage)
+        {
+            ThrowMalformed(pageNumber);
+        }
+        const uint32_t cellCount = ReadBigEndian16(header + 3);
+        const size_t pointers = HeaderOffset(pageNumber) + 12;
+        if (pointers + 2 * cellCount > m_usableSize)
+        {
+            ThrowMalformed(pageNumber);
+        }
+        // children go on the stack right to left so rows come out in rowid order
+        m_pendingPages.push_back(ReadBigEndian32(header + 8));
+        for (uint32_t i = cellCount; i > 0; --i)
+        {
+            const uint32_t cellOffset = ReadBigEndian16(page + pointers + 2 * (i - 1));
+            if (cellOffset + 4 > m_usableSize)
+            {
+                ThrowMalformed(pageNumber);
+            }
+            m_pendingPages.push_back(ReadBigEndian32(page + cellOffset));
+        }
+    }
+}
+
+void SchemaReader::VisitLeaf(uint32_t pageNumber, const SchemaVisitor& visitor)
+{
+    const unsigned char* page = m_reader.ReadPage(pageNumber);
+    const uint32_t cellCount = ReadBigEndian16(page + HeaderOffset(pageNumber) + 3);
+    const size_t pointers = HeaderOffset(pageNumber) + 8;
+    if (pointers + 2 * cellCount > m_usableSize)
+    {
+        ThrowMalformed(pageNumber);
+    }
+    SchemaRow row;
+    for (uint32_t i = 0; i < cellCount; ++i)
+    {
+        // derived from page on every cell, a spilled record moves the page to another buffer
+        const unsigned char* end = page + m_usableSize;
+        const uint32_t cellOffset = ReadBigEndian16(page + pointers + 2 * i);
+        const unsigned char* cell = page + cellOffset;
+        uint64_t payloadSize = 0;
+        uint64_t rowid = 0;
+        const size_t sizeLength = cellOffset < m_usableSize ? ReadVarint(cell, end, payloadSize) : 0;
+        const size_t rowidLength = sizeLength != 0 ? ReadVarint(cell + sizeLength, end, rowid) : 0;
+        if (rowidLength == 0)
+        {
+            ThrowMalformed(pageNumber);
+        }
+        const unsigned char* local = cell + sizeLength + rowidLength;
+        const uint64_t localSize = LocalPayloadSize(payloadSize, m_usableSize, true);
+        if (localSize + (localSize < payloadSize ? 4 : 0) > static_cast<uint64_t>(end - local))
+        {
+            ThrowMalformed(pageNumber);
+        }
+
+        const bool spilled = localSize < payloadSize;
+        // the size comes from the file, a chain through every page is the most it can hold
+        if (spilled && payloadSize - localSize > static_cast<uint64_t>(m_reader.PageCount()) * (m_usableSize - 4))
+        {
+            ThrowMalformed(pageNumber);
+        }
+        const unsigned char* record = spilled ? AssemblePayload(local, localSize, payloadSize) : local;
+        if (!DecodeSchemaRecord(record, payloadSize, row))
+        {
+            ThrowMalformed(pageNumber);
+        }
+        visitor(row);
+        if (spilled)
+        {
+            page = m_reader.ReadPage(pageNumber); // the overflow pages may have taken its buffer
+        }
+    }
+}
+
+const unsigned char* SchemaReader::AssemblePayload(const unsigned char* local, uint64_t localSize, uint64_t payloadSize)
+{
+    m_payload.resize(payloadSize);
+    std::memcpy(m_payload.data(), local, localSize);
+    uint32_t overflowPage = ReadBigEndian32(local + localSize);
+    uint64_t assembled = localSize;
+    uint32_t pagesFollowed = 0;
+    while (assembled < payloadSize)
+    {
+        if (overflowPage == 0 || ++pagesFollowed > m_reader.PageCount())
+        {
+            ThrowMalformed(overflowPage);
+        }
+        const unsigned char* page = m_reader.ReadPage(overflowPage);
+        const uint64_t part = std::min<uint64_t>(payloadSize - assembled, m_usableSize - 4);
+        std::memcpy(m_payload.data() + assembled, page + 4, part);
+        assembled += part;
+        overflowPage = ReadBigEndian32(page);
+    }
+    return m_payload.data();
+}
+
+std::vector<SchemaEntry> ReadSchema(const std::string& filePath)
+{
+    PageReader reader(filePath, 16, 0);
+    std::vector<SchemaEntry> entries;
+    SchemaReader(reader).Visit([&entries](const SchemaRow& row)
+    {
+        entries.push_back(SchemaEntry{std::string(row.type), std::string(row.name), std::string(row.tableName),
+                                      row.rootPage, std::string(row.sql)});
+    });
+    return entries;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "PageReader.h"
+
+// A row of sqlite_master. Text is in the database encoding and points into page buffers,
+// it is only valid inside the visitor call.
+struct SchemaRow
+{
+    std::string_view type; // "table", "index", "view" or "trigger"
+    std::string_view name;
+    std::string_view tableName;
+    int64_t rootPage;
+    std::string_view sql;
+};
+
+using SchemaVisitor = std::function<void(const SchemaRow&)>;
+
+// Owning copy of a schema row for callers that keep the results
+struct SchemaEntry
+{
+    std::string type;
+    std::string name;
+    std::string tableName;
+    int64_t rootPage;
+    std::string sql;
+};
+
+// Decodes the sqlite_master table, the b-tree rooted at page 1, straight from page buffers.
+// Records are read in place, only a record spilled to overflow pages is assembled into
+// a buffer that is reused for every such record.
+// Throws std::runtime_error on a malformed b-tree or record.
+class SchemaReader
+{
+public:
+    explicit SchemaReader(PageReader& reader);
+    void Visit(const SchemaVisitor& visitor);
+
+private:
+    void VisitLeaf(uint32_t pageNumber, const SchemaVisitor& visitor);
+    const unsigned char* AssemblePayload(const unsigned char* local, uint64_t localSize, uint64_t payloadSize);
+
+    PageReader& m_reader;
+    uint32_t m_usableSize;
+    std::vector<uint32_t> m_pendingPages;
+    std::vector<unsigned char> m_payload;
+};
+
+std::vector<SchemaEntry> ReadSchema(const std::string& filePath);
@@ -0,0 +1,224 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+
+#include "SchemaReader.h"
+#include "TestFiles.h"
+
+using namespace test;
+
+namespace
+{
+    const char* const s_testFile = "schemareader_test.db";
+    const uint16_t s_pageSize = 512;
+
+    class TestDatabase
+    {
+    public:
+        explicit TestDatabase(const std::vector<unsigned char>& bytes)
+        {
+            WriteTestFile(s_testFile, bytes);
+        }
+
+        ~TestDatabase()
+        {
+            std::remove(s_testFile);
+        }
+    };
+
+    void AppendText(std::vector<unsigned char>& types, std::vector<unsigned char>& values, const std::string& text)
+    {
+        AppendVarint(types, 13 + 2 * text.size());
+        values.insert(values.end(), text.begin(), text.end());
+    }
+
+    std::vector<unsigned char> SchemaRecord(const std::string& type, const std::string& name, uint16_t rootPage,
+                                            const std::string& sql)
+    {
+        std::vector<unsigned char> types;
+        std::vector<unsigned char> values;
+        AppendText(types, values, type);
+        AppendText(types, values, name);
+        AppendText(types, values, name);
+        types.push_back(2); // two byte integer
+        values.push_back(static_cast<unsigned char>(rootPage >> 8));
+        values.push_back(static_cast<unsigned char>(rootPage));
+        AppendText(types, values, sql);
+
+        std::vector<unsigned char> record(1, static_cast<unsigned char>(types.size() + 1));
+        record.insert(record.end(), types.begin(), types.end());
+        record.insert(record.end(), values.begin(), values.end());
+        return record;
+    }
+
+    std::vector<unsigned char> LeafCell(const std::vector<unsigned char>& record, uint64_t rowid)
+    {
+        std::vector<unsigned char> cell;
+        AppendVarint(cell, record.size());
+        AppendVarint(cell, rowid);
+        cell.insert(cell.end(), record.begin(), record.end());
+        return cell;
+    }
+
+    // Cell keeping the local part of record, the rest is chained from firstOverflowPage on
+    std::vector<unsigned char> SpilledLeafCell(std::vector<unsigned char>& bytes, const std::vector<unsigned char>& record,
+                                               uint64_t rowid, uint32_t firstOverflowPage)
+    {
+        const uint32_t usableSize = s_pageSize;
+        const size_t localSize = static_cast<size_t>(LocalPayloadSize(record.size(), usableSize, true));
+        std::vector<unsigned char> cell;
+        AppendVarint(cell, record.size());
+        AppendVarint(cell, rowid);
+        cell.insert(cell.end(), record.begin(), record.begin() + localSize);
+        cell.resize(cell.size() + 4);
+        WriteBigEndian32(cell, cell.size() - 4, firstOverflowPage);
+        uint32_t overflowPage = firstOverflowPage;
+        for (size_t written = localSize; written < record.size(); written += usableSize - 4, ++overflowPage)
+        {
+            const size_t page = (overflowPage - 1) * s_pageSize;
+            const size_t part = std::min<size_t>(record.size() - written, usableSize - 4);
+            WriteBigEndian32(bytes, page, written + part < record.size() ? overflowPage + 1 : 0);
+            std::copy(record.begin() + written, record.begin() + written + part, bytes.begin() + page + 4);
+        }
+        return cell;
+    }
+
+    std::vector<std::string> VisitNames(PageReader& reader)
+    {
+        std::vector<std::string> names;
+        SchemaReader(reader).Visit([&names](const SchemaRow& row){ names.emplace_back(row.name); });
+        return names;
+    }
+}
+
+TEST(SchemaReader, RowsOfFirstPage)
+{
+    std::vector<unsigned char> bytes = MakeDatabaseBytes(s_pageSize, 3);
+    PageWriter schema(bytes, s_pageSize, 1, g_leafTablePage);
+    schema.AddCell(LeafCell(SchemaRecord("table", "users", 2, "CREATE TABLE users(id)"), 1));
+    schema.AddCell(LeafCell(SchemaRecord("index", "users_id", 3, "CREATE INDEX users_id ON users(id)"), 2));
+    TestDatabase database(bytes);
+
+    PageReader reader(s_testFile);
+    std::vector<SchemaEntry> rows;
+    SchemaReader(reader).Visit([&rows](const SchemaRow& row)
+    {
+        rows.push_back(SchemaEntry{std::string(row.type), std::string(row.name), std::string(row.tableName),
+                                   row.rootPage, std::string(row.sql)});
+    });
+
+    ASSERT_EQ(2u, rows.size());
+    EXPECT_EQ("table", rows[0].type);
+    EXPECT_EQ("users", rows[0].name);
+    EXPECT_EQ("users", rows[0].tableName);
+    EXPECT_EQ(2, rows[0].rootPage);
+    EXPECT_EQ("CREATE TABLE users(id)", rows[0].sql);
+    EXPECT_EQ("index", rows[1].type);
+    EXPECT_EQ(3, rows[1].rootPage);
+}
+
+TEST(SchemaReader, InteriorRootPage)
+{
+    std::vector<unsigned char> bytes = MakeDatabaseBytes(s_pageSize, 3);
+    PageWriter root(bytes, s_pageSize, 1, g_interiorTablePage);
+    root.AddCell({0, 0, 0, 2, 1}); // rows up to 1 are on page 2
+    root.SetRightChild(3);
+    PageWriter(bytes, s_pageSize, 2, g_leafTablePage).AddCell(LeafCell(SchemaRecord("table", "a", 4, ""), 1));
+    PageWriter(bytes, s_pageSize, 3, g_leafTablePage).AddCell(LeafCell(SchemaRecord("table", "b", 5, ""), 2));
+    TestDatabase database(bytes);
+
+    PageReader reader(s_testFile, 1, 0);
+    EXPECT_EQ(std::vector<std::string>({"a", "b"}), VisitNames(reader));
+}
+
+TEST(SchemaReader, FollowOverflowPages)
+{
+    const std::string sql = "CREATE TABLE wide(" + std::string(1500, 'x') + ")";
+    std::vector<unsigned char> bytes = MakeDatabaseBytes(s_pageSize, 8);
+    PageWriter(bytes, s_pageSize, 1, g_leafTablePage).AddCell(SpilledLeafCell(bytes, SchemaRecord("table", "wide", 2, sql), 1, 5));
+    TestDatabase database(bytes);
+
+    PageReader reader(s_testFile, 1, 0);
+    std::string visitedSql;
+    SchemaReader(reader).Visit([&visitedSql](const SchemaRow& row){ visitedSql = std::string(row.sql); });
+    EXPECT_EQ(sql, visitedSql);
+}
+
+TEST(SchemaReader, RowsAfterChainLongerThanCache)
+{
+    // 19 overflow pages evict the leaf from a 16 page cache, so it comes back in another buffer
+    const std::string sql = "CREATE TABLE big(" + std::string(19 * (s_pageSize - 4) + 11, 'x') + ")";
+    std::vector<unsigned char> bytes = MakeDatabaseBytes(s_pageSize, 24);
+    PageWriter schema(bytes, s_pageSize, 1, g_leafTablePage);
+    schema.AddCell(LeafCell(SchemaRecord("table", "a", 2, "CREATE TABLE a(x)"), 1));
+    schema.AddCell(SpilledLeafCell(bytes, SchemaRecord("table", "big", 3, sql), 2, 4));
+    schema.AddCell(LeafCell(SchemaRecord("table", "z", 24, "CREATE TABLE z(x)"), 3));
+    TestDatabase database(bytes);
+
+    PageReader reader(s_testFile, 4, 0);
+    EXPECT_EQ(std::vector<std::string>({"a", "big", "z"}), VisitNames(reader));
+    const std::vector<SchemaEntry> entries = ReadSchema(s_testFile);
+    ASSERT_EQ(3u, entries.size());
+    EXPECT_EQ(sql, entries[1].sql);
+    EXPECT_EQ("CREATE TABLE z(x)", entries[2].sql);
+}
+
+TEST(SchemaReader, FirstPageIsNotTable)
+{
+    std::vector<unsigned char> bytes = MakeDatabaseBytes(s_pageSize, 2);
+    PageWriter(bytes, s_pageSize, 1, g_leafIndexPage);
+    TestDatabase database(bytes);
+
+    PageReader reader(s_testFile);
+    ASSERT_THROW(VisitNames(reader), std::runtime_error);
+}
+
+TEST(SchemaReader, LoopInTree)
+{
+    std::vector<unsigned char> bytes = MakeDatabaseBytes(s_pageSize, 2);
+    PageWriter root(bytes, s_pageSize, 1, g_interiorTablePage);
+    root.SetRightChild(1);
+    TestDatabase database(bytes);
+
+    PageReader reader(s_testFile);
+    ASSERT_THROW(VisitNames(reader), std::runtime_error);
+}
+
+TEST(SchemaReader, RecordLongerThanPayload)
+{
+    std::vector<unsigned char> bytes = MakeDatabaseBytes(s_pageSize, 2);
+    std::vector<unsigned char> record = SchemaRecord("table", "t", 2, "CREATE TABLE t(a)");
+    record.resize(record.size() - 5);
+    PageWriter(bytes, s_pageSize, 1, g_leafTablePage).AddCell(LeafCell(record, 1));
+    TestDatabase database(bytes);
+
+    PageReader reader(s_testFile);
+    ASSERT_THROW(VisitNames(reader), std::runtime_error);
+}
+
+TEST(SchemaReader, PayloadLargerThanFile)
+{
+    std::vector<unsigned char> bytes = MakeDatabaseBytes(s_pageSize, 2);
+    const uint64_t payloadSize = 1ull << 50;
+    std::vector<unsigned char> cell;
+    AppendVarint(cell, payloadSize);
+    AppendVarint(cell, 1);
+    cell.resize(cell.size() + LocalPayloadSize(payloadSize, s_pageSize, true) + 4, 0);
+    WriteBigEndian32(cell, cell.size() - 4, 2);
+    PageWriter(bytes, s_pageSize, 1, g_leafTablePage).AddCell(cell);
+    TestDatabase database(bytes);
+
+    PageReader reader(s_testFile);
+    ASSERT_THROW(VisitNames(reader), std::runtime_error);
+}
+
+TEST(SchemaReader, ReadSchemaOfFile)
+{
+    std::vector<unsigned char> bytes = MakeDatabaseBytes(s_pageSize, 2);
+    PageWriter(bytes, s_pageSize, 1, g_leafTablePage).AddCell(LeafCell(SchemaRecord("view", "v", 0, "CREATE VIEW v"), 1));
+    TestDatabase database(bytes);
+
+    const std::vector<SchemaEntry> schema = ReadSchema(s_testFile);
+    ASSERT_EQ(1u, schema.size());
+    EXPECT_EQ("view", schema[0].type);
+    EXPECT_EQ("CREATE VIEW v", schema[0].sql);
+}
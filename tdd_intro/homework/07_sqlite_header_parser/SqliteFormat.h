@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+// Layout of the database header, see https://www.sqlite.org/fileformat.html
+const size_t g_sqliteHeaderSize = 100;
+const size_t g_sqliteMagicSize = 16;
+const char g_sqliteMagic[g_sqliteMagicSize] = "SQLite format 3"; // with the terminating zero
+
+// All multibyte fields of the file format are big-endian
+inline uint16_t ReadBigEndian16(const unsigned char* bytes)
+{
+    return static_cast<uint16_t>((bytes[0] << 8) | bytes[1]);
+}
+
+inline uint32_t ReadBigEndian32(const unsigned char* bytes)
+{
+    return (static_cast<uint32_t>(bytes[0]) << 24) | (static_cast<uint32_t>(bytes[1]) << 16) |
+           (static_cast<uint32_t>(bytes[2]) << 8) | static_cast<uint32_t>(bytes[3]);
+}
+
+// Decodes a 1 to 9 byte variable-length integer, returns the number of bytes used
+// or 0 when the integer does not fit before end
+inline size_t ReadVarint(const unsigned char* bytes, const unsigned char* end, uint64_t& value)
+{
+    value = 0;
+    for (size_t i = 0; i < 8; ++i)
+    {
+        if (bytes + i >= end)
+        {
+            return 0;
+        }
+        value = (value << 7) | (bytes[i] & 0x7f);
+        if ((bytes[i] & 0x80) == 0)
+        {
+            return i + 1;
+        }
+    }
+    if (bytes + 8 >= end)
+    {
+        return 0;
+    }
+    value = (value << 8) | bytes[8];
+    return 9;
+}
+
+// B-tree page types, the first byte of the page header
+const unsigned char g_interiorIndexPage = 0x02;
+const unsigned char g_interiorTablePage = 0x05;
+const unsigned char g_leafIndexPage = 0x0a;
+const unsigned char g_leafTablePage = 0x0d;
+
+// Bytes of a cell payload stored on the b-tree page itself, the rest goes to overflow pages.
+// usableSize is the page size without the reserved bytes.
+inline uint64_t LocalPayloadSize(uint64_t payloadSize, uint32_t usableSize, bool tableLeaf)
+{
+    const uint64_t maxLocal = tableLeaf ? usableSize - 35 : (usableSize - 12) * 64 / 255 - 23;
+    if (payloadSize <= maxLocal)
+    {
+        return payloadSize;
+    }
+    const uint64_t minLocal = (usableSize - 12) * 32 / 255 - 23;
+    const uint64_t local = minLocal + (payloadSize - minLocal) % (usableSize - 4);
+    return local <= maxLocal ? local : minLocal;
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "SqliteFormat.h"
+
+// Helpers for tests that need database files on disk
+namespace test
+{
+    inline void WriteBigEndian16(std::vector<unsigned char>& bytes, size_t offset, uint16_t value)
+    {
+        bytes[offset] = static_cast<unsigned char>(value >> 8);
+        bytes[offset + 1] = static_cast<unsigned char>(value);
+    }
+
+    inline void WriteBigEndian32(std::vector<unsigned char>& bytes, size_t offset, uint32_t value)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            bytes[offset + i] = static_cast<unsigned char>(value >> (24 - 8 * i));
+        }
+    }
+
+    inline std::vector<unsigned char> MakeHeaderBytes()
+    {
+        std::vector<unsigned char> bytes(g_sqliteHeaderSize, 0);
+        std::copy(g_sqliteMagic, g_sqliteMagic + g_sqliteMagicSize, bytes.begin());
+        WriteBigEndian16(bytes, 16, 4096);
+        bytes[18] = 2;
+        bytes[19] = 2;
+        bytes[20] = 8;
+        bytes[21] = 64;
+        bytes[22] = 32;
+        bytes[23] = 32;
+        WriteBigEndian32(bytes, 24, 0x01020304);
+        WriteBigEndian32(bytes, 28, 30);
+        WriteBigEndian32(bytes, 32, 20);
+        WriteBigEndian32(bytes, 36, 5);
+        WriteBigEndian32(bytes, 40, 7);
+        WriteBigEndian32(bytes, 44, 4);
+        WriteBigEndian32(bytes, 48, 2000);
+        WriteBigEndian32(bytes, 52, 3);
+        WriteBigEndian32(bytes, 56, 1);
+        WriteBigEndian32(bytes, 60, 42);
+        WriteBigEndian32(bytes, 64, 1);
+        WriteBigEndian32(bytes, 68, 0x0F0F0F0F);
+        WriteBigEndian32(bytes, 92, 0x01020304);
+        WriteBigEndian32(bytes, 96, 3024000);
+        return bytes;
+    }
+
+    inline void WriteTestFile(const std::string& filePath, const std::vector<unsigned char>& bytes)
+    {
+        std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    }
+
+    inline std::vector<unsigned char> ReadTestFile(const std::string& filePath)
+    {
+        std::ifstream file(filePath, std::ios::binary);
+        return std::vector<unsigned char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    // Database of pageCount pages, every page after the header is filled with its page number
+    inline std::vector<unsigned char> MakeDatabaseBytes(uint16_t pageSize, uint32_t pageCount)
+    {
+        std::vector<unsigned char> bytes = MakeHeaderBytes();
+        WriteBigEndian16(bytes, 16, pageSize);
+        bytes[20] = 0;
+        WriteBigEndian32(bytes, 28, pageCount);
+        WriteBigEndian32(bytes, 32, 0);
+        WriteBigEndian32(bytes, 36, 0);
+        WriteBigEndian32(bytes, 52, 0); // no auto-vacuum, so no pointer map pages
+        WriteBigEndian32(bytes, 64, 0);
+        WriteBigEndian32(bytes, 92, ReadBigEndian32(bytes.data() + 24));
+        const size_t realPageSize = pageSize == 1 ? 65536 : pageSize;
+        bytes.resize(realPageSize * pageCount);
+        for (uint32_t page = 1; page <= pageCount; ++page)
+        {
+            const size_t begin = page == 1 ? g_sqliteHeaderSize : (page - 1) * realPageSize;
+            std::fill(bytes.begin() + begin, bytes.begin() + page * realPageSize, static_cast<unsigned char>(page));
+        }
+        return bytes;
+    }
+
+    // Lays out b-tree pages the way sqlite does: cells grow from the page end towards the header
+    class PageWriter
+    {
+    public:
+        PageWriter(std::vector<unsigned char>& bytes, uint32_t pageSize, uint32_t pageNumber, unsigned char pageType)
+            : m_bytes(bytes)
+            , m_page((pageNumber - 1) * pageSize)
+            , m_header(m_page + (pageNumber == 1 ? g_sqliteHeaderSize : 0))
+            , m_pointers(m_header + (pageType == g_interiorIndexPage || pageType == g_interiorTablePage ? 12 : 8))
+            , m_contentBegin(pageSize)
+            , m_cellCount(0)
+        {
+            std::fill(m_bytes.begin() + m_header, m_bytes.begin() + m_page + pageSize, 0);
+            m_bytes[m_header] = pageType;
+            Update();
+        }
+
+        void SetRightChild(uint32_t pageNumber)
+        {
+            WriteBigEndian32(m_bytes, m_header + 8, pageNumber);
+        }
+
+        void AddCell(const std::vector<unsigned char>& cell)
+        {
+            m_contentBegin -= static_cast<uint32_t>(cell.size());
+            std::copy(cell.begin(), cell.end(), m_bytes.begin() + m_page + m_contentBegin);
+            WriteBigEndian16(m_bytes, m_pointers + 2 * m_cellCount, static_cast<uint16_t>(m_contentBegin));
+            ++m_cellCount;
+            Update();
+        }
+
+    private:
+        void Update()
+        {
+            WriteBigEndian16(m_bytes, m_header + 3, m_cellCount);
+            WriteBigEndian16(m_bytes, m_header + 5, static_cast<uint16_t>(m_contentBegin));
+        }
+
+        std::vector<unsigned char>& m_bytes;
+        const size_t m_page;
+        const size_t m_header;
+        const size_t m_pointers;
+        uint32_t m_contentBegin;
+        uint16_t m_cellCount;
+    };
+
+    inline void AppendVarint(std::vector<unsigned char>& cell, uint64_t value)
+    {
+        if (value >= 0x80)
+        {
+            AppendVarint(cell, value >> 7);
+            cell.back() |= 0x80;
+        }
+        cell.push_back(static_cast<unsigned char>(value & 0x7f));
+    }
+}
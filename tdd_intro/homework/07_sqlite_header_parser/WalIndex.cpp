@@ -0,0 +1,158 @@
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "WalIndex.h"
+#include "FileIo.h"
+#include "SqliteFormat.h"
+
+namespace
+{
+    const uint32_t g_walFormatVersion = 3007000;
+
+    inline uint32_t ReadLittleEndian32(const unsigned char* bytes)
+    {
+        return (static_cast<uint32_t>(bytes[3]) << 24) | (static_cast<uint32_t>(bytes[2]) << 16) |
+               (static_cast<uint32_t>(bytes[1]) << 8) | static_cast<uint32_t>(bytes[0]);
+    }
+
+    WalHeader DecodeWalHeader(const unsigned char* bytes)
+    {
+        WalHeader header;
+        header.magic = ReadBigEndian32(bytes);
+        header.formatVersion = ReadBigEndian32(bytes + 4);
+        header.pageSize = ReadBigEndian32(bytes + 8);
+        header.checkpointSequence = ReadBigEndian32(bytes + 12);
+        header.salt1 = ReadBigEndian32(bytes + 16);
+        header.salt2 = ReadBigEndian32(bytes + 20);
+        header.checksum1 = ReadBigEndian32(bytes + 24);
+        header.checksum2 = ReadBigEndian32(bytes + 28);
+        return header;
+    }
+
+    bool IsValidPageSize(uint32_t pageSize)
+    {
+        return pageSize >= 512 && pageSize <= 65536 && (pageSize & (pageSize - 1)) == 0;
+    }
+}
+
+void WalChecksum(const unsigned char* data, size_t size, bool bigEndian, uint32_t& s0, uint32_t& s1)
+{
+    const unsigned char* end = data + size;
+    if (bigEndian)
+    {
+        for (; data < end; data += 8)
+        {
+            s0 += ReadBigEndian32(data) + s1;
+            s1 += ReadBigEndian32(data + 4) + s0;
+        }
+    }
+    else
+    {
+        for (; data < end; data += 8)
+        {
+            s0 += ReadLittleEndian32(data) + s1;
+            s1 += ReadLittleEndian32(data + 4) + s0;
+        }
+    }
+}
+
+std::string WalPathFor(const std::string& databasePath)
+{
+    return databasePath + "-wal";
+}
+
+WalIndex ParseWal(const std::string& walPath, size_t chunkBytes)
+{
+    File file;
+    if (!file.Open(walPath))
+    {
+        throw std::runtime_error("Can not open " + walPath);
+    }
+
+    WalIndex index;
+    unsigned char headerBytes[g_walHeaderSize];
+    const int64_t headerRead = file.ReadAt(headerBytes, sizeof(headerBytes), 0);
+    if (headerRead < 0)
+    {
+        throw std::runtime_error("Can not read " + walPath);
+    }
+    index.bytesRead = static_cast<uint64_t>(headerRead);
+    if (headerRead != static_cast<int64_t>(sizeof(headerBytes)))
+    {
+        return index;
+    }
+    index.header = DecodeWalHeader(headerBytes);
+    const bool bigEndian = (index.header.magic & 1) != 0;
+    uint32_t s0 = 0;
+    uint32_t s1 = 0;
+    WalChecksum(headerBytes, 24, bigEndian, s0, s1);
+    index.validHeader = (index.header.magic & ~1u) == g_walMagic &&
+                        index.header.formatVersion == g_walFormatVersion &&
+                        IsValidPageSize(index.header.pageSize) &&
+                        s0 == index.header.checksum1 && s1 == index.header.checksum2;
+    if (!index.validHeader)
+    {
+        return index;
+    }
+
+    const size_t frameSize = g_walFrameHeaderSize + index.header.pageSize;
+    const int64_t fileSize = file.Size();
+    if (fileSize < 0)
+    {
+        throw std::runtime_error("Can not read " + walPath);
+    }
+    index.framesInFile = static_cast<uint32_t>(std::max<int64_t>(0, fileSize - static_cast<int64_t>(g_walHeaderSize)) / frameSize);
+
+    const size_t framesInChunk = std::max<size_t>(1, chunkBytes / frameSize);
+    std::vector<unsigned char> chunk(framesInChunk * frameSize);
+    std::vector<std::pair<uint32_t, uint32_t>> transaction; // frames since the last commit
+    uint32_t frameNumber = 0;
+    bool chainBroken = false; // a broken checksum ends the log, nothing after it is read
+    uint64_t offset = g_walHeaderSize;
+    while (!chainBroken)
+    {
+        const int64_t bytesRead = file.ReadAt(chunk.data(), chunk.size(), offset);
+        if (bytesRead < 0)
+        {
+            throw std::runtime_error("Can not read " + walPath);
+        }
+        index.bytesRead += static_cast<uint64_t>(bytesRead);
+        const size_t frames = static_cast<size_t>(bytesRead) / frameSize;
+        for (size_t i = 0; i < frames; ++i)
+        {
+            ++frameNumber;
+            const unsigned char* frame = chunk.data() + i * frameSize;
+            const uint32_t pageNumber = ReadBigEndian32(frame);
+            const uint32_t databaseSize = ReadBigEndian32(frame + 4);
+            WalChecksum(frame, 8, bigEndian, s0, s1);
+            WalChecksum(frame + g_walFrameHeaderSize, index.header.pageSize, bigEndian, s0, s1);
+            if (pageNumber == 0 ||
+                ReadBigEndian32(frame + 8) != index.header.salt1 || ReadBigEndian32(frame + 12) != index.header.salt2 ||
+                ReadBigEndian32(frame + 16) != s0 || ReadBigEndian32(frame + 20) != s1)
+            {
+                chainBroken = true;
+                break;
+            }
+            transaction.emplace_back(pageNumber, frameNumber);
+            if (databaseSize != 0)
+            {
+                for (const auto& pageFrame : transaction)
+                {
+                    index.latestFrame[pageFrame.first] = pageFrame.second;
+                }
+                transaction.clear();
+                index.validFrames = frameNumber;
+                index.databaseSize = databaseSize;
+                ++index.commits;
+            }
+        }
+        if (static_cast<size_t>(bytesRead) < chunk.size())
+        {
+            break;
+        }
+        offset += chunk.size();
+    }
+    return index;
+}
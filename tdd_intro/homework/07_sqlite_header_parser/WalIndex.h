@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+const size_t g_walHeaderSize = 32;
+const size_t g_walFrameHeaderSize = 24;
+const uint32_t g_walMagic = 0x377f0682; // the lowest bit set means big-endian checksums
+const size_t g_defaultWalChunkBytes = 4 * 1024 * 1024;
+
+struct WalHeader
+{
+    uint32_t magic = 0;
+    uint32_t formatVersion = 0;
+    uint32_t pageSize = 0;
+    uint32_t checkpointSequence = 0;
+    uint32_t salt1 = 0;
+    uint32_t salt2 = 0;
+    uint32_t checksum1 = 0;
+    uint32_t checksum2 = 0;
+};
+
+struct WalIndex
+{
+    WalHeader header;
+    bool validHeader = false;
+    uint32_t framesInFile = 0; // whole frames present in the file, from its size
+    uint32_t validFrames = 0; // frames up to the last commit whose checksums chain correctly
+    uint32_t commits = 0;
+    uint32_t databaseSize = 0; // database size in pages after the last commit
+    uint64_t bytesRead = 0;
+    std::unordered_map<uint32_t, uint32_t> latestFrame; // page number -> 1-based frame number
+
+    // Upper bound of the pages a checkpoint would write back to the database: every page of a
+    // committed frame is counted, also pages an earlier checkpoint already copied back. How
+    // far the log was backfilled is kept in the -shm file, which is not read.
+    size_t PendingCheckpointPages() const
+    {
+        return latestFrame.size();
+    }
+};
+
+// Adds the words of data to the running WAL checksum, size must be a multiple of 8
+void WalChecksum(const unsigned char* data, size_t size, bool bigEndian, uint32_t& s0, uint32_t& s1);
+
+// The write-ahead log of a database lives next to it with the "-wal" suffix
+std::string WalPathFor(const std::string& databasePath);
+
+// Reads the WAL in one sequential pass with chunks of about chunkBytes and verifies the
+// cumulative frame checksums on the way. Frames after the first broken one and frames of
+// a transaction without a commit frame are not part of the log and are not indexed, the
+// pass stops at the chunk holding the first broken frame.
+// Throws std::runtime_error when the file can not be opened or read.
+WalIndex ParseWal(const std::string& walPath, size_t chunkBytes = g_defaultWalChunkBytes);
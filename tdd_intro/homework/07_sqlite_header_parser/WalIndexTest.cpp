@@ -0,0 +1,195 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+
+#include "WalIndex.h"
+#include "TestFiles.h"
+
+using namespace test;
+
+namespace
+{
+    const char* const s_testFile = "walindex_test.db-wal";
+    const uint32_t s_pageSize = 512;
+
+    // Writes frames the way sqlite does, every checksum continues from the previous one
+    class WalWriter
+    {
+    public:
+        explicit WalWriter(bool bigEndian = true)
+            : m_bytes(g_walHeaderSize, 0)
+            , m_bigEndian(bigEndian)
+            , m_s0(0)
+            , m_s1(0)
+        {
+            WriteBigEndian32(m_bytes, 0, g_walMagic | (bigEndian ? 1 : 0));
+            WriteBigEndian32(m_bytes, 4, 3007000);
+            WriteBigEndian32(m_bytes, 8, s_pageSize);
+            WriteBigEndian32(m_bytes, 16, 0x1234);
+            WriteBigEndian32(m_bytes, 20, 0x5678);
+            WalChecksum(m_bytes.data(), 24, m_bigEndian, m_s0, m_s1);
+            WriteBigEndian32(m_bytes, 24, m_s0);
+            WriteBigEndian32(m_bytes, 28, m_s1);
+        }
+
+        void AddFrame(uint32_t pageNumber, uint32_t databaseSize = 0)
+        {
+            const size_t frame = m_bytes.size();
+            m_bytes.resize(frame + g_walFrameHeaderSize + s_pageSize, static_cast<unsigned char>(pageNumber));
+            WriteBigEndian32(m_bytes, frame, pageNumber);
+            WriteBigEndian32(m_bytes, frame + 4, databaseSize);
+            std::copy(m_bytes.begin() + 16, m_bytes.begin() + 24, m_bytes.begin() + frame + 8); // salts
+            WalChecksum(m_bytes.data() + frame, 8, m_bigEndian, m_s0, m_s1);
+            WalChecksum(m_bytes.data() + frame + g_walFrameHeaderSize, s_pageSize, m_bigEndian, m_s0, m_s1);
+            WriteBigEndian32(m_bytes, frame + 16, m_s0);
+            WriteBigEndian32(m_bytes, frame + 20, m_s1);
+        }
+
+        std::vector<unsigned char>& Bytes()
+        {
+            return m_bytes;
+        }
+
+        size_t FrameOffset(uint32_t frameNumber) const
+        {
+            return g_walHeaderSize + (frameNumber - 1) * (g_walFrameHeaderSize + s_pageSize);
+        }
+
+    private:
+        std::vector<unsigned char> m_bytes;
+        const bool m_bigEndian;
+        uint32_t m_s0;
+        uint32_t m_s1;
+    };
+
+    WalIndex ParseTestWal(const std::vector<unsigned char>& bytes, size_t chunkBytes = g_defaultWalChunkBytes)
+    {
+        WriteTestFile(s_testFile, bytes);
+        const WalIndex index = ParseWal(s_testFile, chunkBytes);
+        std::remove(s_testFile);
+        return index;
+    }
+}
+
+TEST(WalIndex, FileNotExist)
+{
+    ASSERT_THROW(ParseWal("no_such_file.db-wal"), std::runtime_error);
+}
+
+TEST(WalIndex, EmptyWal)
+{
+    const WalIndex index = ParseTestWal({});
+    EXPECT_FALSE(index.validHeader);
+    EXPECT_EQ(0u, index.PendingCheckpointPages());
+}
+
+TEST(WalIndex, HeaderOnly)
+{
+    WalWriter wal;
+    const WalIndex index = ParseTestWal(wal.Bytes());
+    EXPECT_TRUE(index.validHeader);
+    EXPECT_EQ(s_pageSize, index.header.pageSize);
+    EXPECT_EQ(0x1234u, index.header.salt1);
+    EXPECT_EQ(0u, index.framesInFile);
+}
+
+TEST(WalIndex, BadHeaderChecksum)
+{
+    WalWriter wal;
+    wal.Bytes()[12] = 1; // checkpoint sequence is covered by the checksum
+    EXPECT_FALSE(ParseTestWal(wal.Bytes()).validHeader);
+}
+
+TEST(WalIndex, LatestFrameOfEveryPage)
+{
+    WalWriter wal;
+    wal.AddFrame(2);
+    wal.AddFrame(3, 3);
+    wal.AddFrame(2, 4);
+    const WalIndex index = ParseTestWal(wal.Bytes());
+
+    EXPECT_EQ(3u, index.validFrames);
+    EXPECT_EQ(2u, index.commits);
+    EXPECT_EQ(4u, index.databaseSize);
+    EXPECT_EQ(2u, index.PendingCheckpointPages());
+    EXPECT_EQ(3u, index.latestFrame.at(2));
+    EXPECT_EQ(2u, index.latestFrame.at(3));
+}
+
+TEST(WalIndex, LittleEndianChecksums)
+{
+    WalWriter wal(false);
+    wal.AddFrame(5, 5);
+    const WalIndex index = ParseTestWal(wal.Bytes());
+    EXPECT_EQ(1u, index.validFrames);
+    EXPECT_EQ(1u, index.latestFrame.at(5));
+}
+
+TEST(WalIndex, UncommittedFramesAreIgnored)
+{
+    WalWriter wal;
+    wal.AddFrame(2, 2);
+    wal.AddFrame(3);
+    wal.AddFrame(4);
+    const WalIndex index = ParseTestWal(wal.Bytes());
+
+    EXPECT_EQ(3u, index.framesInFile);
+    EXPECT_EQ(1u, index.validFrames);
+    EXPECT_EQ(1u, index.PendingCheckpointPages());
+}
+
+TEST(WalIndex, BrokenChecksumEndsTheLog)
+{
+    WalWriter wal;
+    wal.AddFrame(2, 2);
+    wal.AddFrame(3, 3);
+    wal.AddFrame(4, 4);
+    wal.Bytes()[wal.FrameOffset(2) + g_walFrameHeaderSize] ^= 1;
+    const WalIndex index = ParseTestWal(wal.Bytes());
+
+    EXPECT_EQ(3u, index.framesInFile);
+    EXPECT_EQ(1u, index.validFrames);
+    EXPECT_EQ(0u, index.latestFrame.count(4));
+}
+
+TEST(WalIndex, NothingReadAfterBrokenChecksum)
+{
+    WalWriter wal;
+    for (uint32_t frame = 1; frame <= 10; ++frame)
+    {
+        wal.AddFrame(frame + 1, frame + 1);
+    }
+    wal.Bytes()[wal.FrameOffset(3) + 16] ^= 1;
+    const WalIndex index = ParseTestWal(wal.Bytes(), 1); // one frame per read
+
+    EXPECT_EQ(10u, index.framesInFile);
+    EXPECT_EQ(2u, index.validFrames);
+    EXPECT_EQ(wal.FrameOffset(4), index.bytesRead);
+}
+
+TEST(WalIndex, FramesOfPreviousGenerationAreIgnored)
+{
+    WalWriter wal;
+    wal.AddFrame(2, 2);
+    wal.AddFrame(3, 3);
+    wal.Bytes()[wal.FrameOffset(2) + 8] ^= 1; // salt written before the last checkpoint restart
+    const WalIndex index = ParseTestWal(wal.Bytes());
+
+    EXPECT_EQ(1u, index.validFrames);
+}
+
+TEST(WalIndex, SmallChunksGiveSameResult)
+{
+    WalWriter wal;
+    for (uint32_t frame = 1; frame <= 20; ++frame)
+    {
+        wal.AddFrame(frame % 7 + 1, frame % 3 == 0 ? 8 : 0);
+    }
+    wal.Bytes().resize(wal.Bytes().size() - 10); // torn last frame
+    const WalIndex whole = ParseTestWal(wal.Bytes());
+    const WalIndex chunked = ParseTestWal(wal.Bytes(), 1);
+
+    EXPECT_EQ(19u, whole.framesInFile);
+    EXPECT_EQ(18u, whole.validFrames);
+    EXPECT_EQ(whole.validFrames, chunked.validFrames);
+    EXPECT_EQ(whole.latestFrame, chunked.latestFrame);
+}
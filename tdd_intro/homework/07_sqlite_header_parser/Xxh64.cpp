@@ -0,0 +1,101 @@
+#include <cstring>
+
+#include "Xxh64.h"
+
+namespace
+{
+    const uint64_t g_prime1 = 0x9E3779B185EBCA87ull;
+    const uint64_t g_prime2 = 0xC2B2AE3D27D4EB4Full;
+    const uint64_t g_prime3 = 0x165667B19E3779F9ull;
+    const uint64_t g_prime4 = 0x85EBCA77C2B2AE63ull;
+    const uint64_t g_prime5 = 0x27D4EB2F165667C5ull;
+
+    inline uint64_t RotateLeft(uint64_t value, int bits)
+    {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    // The hash is defined on little-endian words
+    inline uint64_t Load64(const unsigned char* bytes)
+    {
+        uint64_t value = 0;
+        for (int i = 7; i >= 0; --i)
+        {
+            value = (value << 8) | bytes[i];
+        }
+        return value;
+    }
+
+    inline uint32_t Load32(const unsigned char* bytes)
+    {
+        return static_cast<uint32_t>(bytes[0]) | (static_cast<uint32_t>(bytes[1]) << 8) |
+               (static_cast<uint32_t>(bytes[2]) << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+    }
+
+    inline uint64_t Round(uint64_t accumulator, uint64_t input)
+    {
+        accumulator += input * g_prime2;
+        return RotateLeft(accumulator, 31) * g_prime1;
+    }
+
+    inline uint64_t MergeRound(uint64_t hash, uint64_t accumulator)
+    {
+        hash ^= Round(0, accumulator);
+        return hash * g_prime1 + g_prime4;
+    }
+}
+
+uint64_t Xxh64(const void* data, size_t size, uint64_t seed)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    const unsigned char* const end = bytes + size;
+    uint64_t hash;
+    if (size >= 32)
+    {
+        uint64_t v1 = seed + g_prime1 + g_prime2;
+        uint64_t v2 = seed + g_prime2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - g_prime1;
+        for (const unsigned char* limit = end - 32; bytes <= limit; bytes += 32)
+        {
+            v1 = Round(v1, Load64(bytes));
+            v2 = Round(v2, Load64(bytes + 8));
+            v3 = Round(v3, Load64(bytes + 16));
+            v4 = Round(v4, Load64(bytes + 24));
+        }
+        hash = RotateLeft(v1, 1) + RotateLeft(v2, 7) + RotateLeft(v3, 12) + RotateLeft(v4, 18);
+        hash = MergeRound(hash, v1);
+        hash = MergeRound(hash, v2);
+        hash = MergeRound(hash, v3);
+        hash = MergeRound(hash, v4);
+    }
+    else
+    {
+        hash = seed + g_prime5;
+    }
+    hash += static_cast<uint64_t>(size);
+
+    for (; bytes + 8 <= end; bytes += 8)
+    {
+        hash ^= Round(0, Load64(bytes));
+        hash = RotateLeft(hash, 27) * g_prime1 + g_prime4;
+    }
+    if (bytes + 4 <= end)
+    {
+        hash ^= static_cast<uint64_t>(Load32(bytes)) * g_prime1;
+        hash = RotateLeft(hash, 23) * g_prime2 + g_prime3;
+        bytes += 4;
+    }
+    for (; bytes < end; ++bytes)
+    {
+        hash ^= *bytes * g_prime5;
+        hash = RotateLeft(hash, 11) * g_prime1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= g_prime2;
+    hash ^= hash >> 29;
+    hash *= g_prime3;
+    hash ^= hash >> 32;
+    return hash;
+}
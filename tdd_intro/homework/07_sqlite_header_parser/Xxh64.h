@@ -0,0 +1,7 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// XXH64 by Yann Collet, https://github.com/Cyan4973/xxHash, a fast non-cryptographic hash
+uint64_t Xxh64(const void* data, size_t size, uint64_t seed = 0);
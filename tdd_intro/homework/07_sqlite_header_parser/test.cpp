@@ -42,6 +42,7 @@ Offset	Size	Description
 #include <gmock/gmock.h>
 
 #include "Mocks.h"
+#include "HeaderDisplay.h"
 using namespace testing;
 
 const SqliteHeader g_testHeader{"SQLite format 3",
@@ -68,37 +69,11 @@ const SqliteHeader g_testHeader{"SQLite format 3",
                         3,
                         22};
 
-
-void DysplayHeaderStructure(IGui* gui, IDbReader* dbReader)
+void ExpectValidHeader(DbReaderMock& dbReader)
 {
-    if (gui == nullptr || dbReader->IsEmpty() || !dbReader->CheckHeader())
-    {
-        throw std::exception();
-    }
-    std::vector<std::string> messagesForOutput;
-    messagesForOutput.push_back("Type - " + dbReader->GetHeaderString());
-    messagesForOutput.push_back("DB page size - " + std::to_string(dbReader->GetPageSize()));
-    messagesForOutput.push_back("File format write version - " + std::to_string(dbReader->GetFormatWriteVersion()));
-    messagesForOutput.push_back("File format read version - " + std::to_string(dbReader->GetFormatReadVersion()));
-    messagesForOutput.push_back("Unused bytes - " + std::to_string(dbReader->GetUnsedBytes()));
-    messagesForOutput.push_back("Maximum embedded payload fraction - " + std::to_string(dbReader->GetMaximumEmbeddedPayloadFraction()));
-    messagesForOutput.push_back("Minimum embedded payload fraction - " + std::to_string(dbReader->GetMinimumEmbeddedPayloadFraction()));
-    messagesForOutput.push_back("Leaf payload fraction - " + std::to_string(dbReader->GetLeafPayloadFraction()));
-    messagesForOutput.push_back("File change counter - " + std::to_string(dbReader->GetFileChangeCounter()));
-    messagesForOutput.push_back("Size of the database file in pages - " + std::to_string(dbReader->GetPageCount()));
-    messagesForOutput.push_back("Page number of the first freelist trunk page - " + std::to_string(dbReader->GetFirstFreelistPage()));
-    messagesForOutput.push_back("Total number of freelist pages - " + std::to_string(dbReader->GetFreelistPageCount()));
-    messagesForOutput.push_back("The schema format number - " + std::to_string(dbReader->GetSchemaFormat()));
-    messagesForOutput.push_back("Default page cache size - " + std::to_string(dbReader->GetDefaultPageCacheSize()));
-    messagesForOutput.push_back("The page number of the largest root b-tree page - " + std::to_string(dbReader->GetNumberOfLargestRootPage()));
-    messagesForOutput.push_back("The database text encoding - " + std::to_string(dbReader->GetDatabaseTextEncoding()));
-    messagesForOutput.push_back("The \"user version\" - " + std::to_string(dbReader->GetUserVersion()));
-    messagesForOutput.push_back("The vacuum mode - " + std::to_string(dbReader->GetIncrementalVacuumMode()));
-    messagesForOutput.push_back("The \"Application ID\" - " + std::to_string(dbReader->GetApplicationId()));
-    messagesForOutput.push_back("The version-valid-for number - " + std::to_string(dbReader->GetVersionValidNumber()));
-    messagesForOutput.push_back("The SQLITE_VERSION_NUMBER - " + std::to_string(dbReader->GetSqliteVersionNumber()));
-
-    gui->DisplayHeader(messagesForOutput);
+    EXPECT_CALL(dbReader, IsEmpty()).WillOnce(Return(false));
+    EXPECT_CALL(dbReader, CheckHeader()).WillOnce(Return(true));
+    EXPECT_CALL(dbReader, ReadHeader()).WillOnce(Return(g_testHeader));
 }
 
 TEST(SqliteHeaderReader, NoGui)
@@ -133,11 +108,8 @@ TEST(SqliteHeaderReader, ReadHeadString)
     DbReaderMock dbReader;
     GuiMock gui;
 
-    EXPECT_CALL(dbReader, IsEmpty()).WillOnce(Return(false));
-    EXPECT_CALL(dbReader, CheckHeader()).WillOnce(Return(true));
-    EXPECT_CALL(dbReader, GetHeaderString()).WillOnce(Return(g_testHeader.head));
-
-    EXPECT_CALL(gui, DisplayHeader(_)).Times(1);
+    ExpectValidHeader(dbReader);
+    EXPECT_CALL(gui, DisplayHeader(Contains("Type - SQLite format 3"))).Times(1);
 
     ASSERT_NO_THROW(DysplayHeaderStructure(&gui, &dbReader));
 }
@@ -147,11 +119,8 @@ TEST(SqliteHeaderReader, ReadDbPageSize)
     DbReaderMock dbReader;
     GuiMock gui;
 
-    EXPECT_CALL(dbReader, IsEmpty()).WillOnce(Return(false));
-    EXPECT_CALL(dbReader, CheckHeader()).WillOnce(Return(true));
-    EXPECT_CALL(dbReader, GetPageSize()).WillOnce(Return(g_testHeader.pageSize));
-
-    EXPECT_CALL(gui, DisplayHeader(_)).Times(1);
+    ExpectValidHeader(dbReader);
+    EXPECT_CALL(gui, DisplayHeader(Contains("DB page size - 512"))).Times(1);
 
     ASSERT_NO_THROW(DysplayHeaderStructure(&gui, &dbReader));
 }
@@ -161,10 +130,8 @@ TEST(SqliteHeaderReader, ReadFileWriteFormatVersion)
     DbReaderMock dbReader;
     GuiMock gui;
 
-    EXPECT_CALL(dbReader, IsEmpty()).WillOnce(Return(false));
-    EXPECT_CALL(dbReader, CheckHeader()).WillOnce(Return(true));
-    EXPECT_CALL(dbReader, GetFormatWriteVersion()).WillOnce(Return(g_testHeader.fileFormatWriteVersion));
-    EXPECT_CALL(gui, DisplayHeader(_)).Times(1);
+    ExpectValidHeader(dbReader);
+    EXPECT_CALL(gui, DisplayHeader(Contains("File format write version - 1"))).Times(1);
 
     ASSERT_NO_THROW(DysplayHeaderStructure(&gui, &dbReader));
 }
@@ -174,10 +141,8 @@ TEST(SqliteHeaderReader, ReadFileReadFormatVersion)
     DbReaderMock dbReader;
     GuiMock gui;
 
-    EXPECT_CALL(dbReader, IsEmpty()).WillOnce(Return(false));
-    EXPECT_CALL(dbReader, CheckHeader()).WillOnce(Return(true));
-    EXPECT_CALL(dbReader, GetFormatReadVersion()).WillOnce(Return(g_testHeader.fileFormatReadVersion));
-    EXPECT_CALL(gui, DisplayHeader(_)).Times(1);
+    ExpectValidHeader(dbReader);
+    EXPECT_CALL(gui, DisplayHeader(Contains("File format read version - 1"))).Times(1);
 
     ASSERT_NO_THROW(DysplayHeaderStructure(&gui, &dbReader));
 }
@@ -187,10 +152,8 @@ TEST(SqliteHeaderReader, ReadUnusedBytes)
     DbReaderMock dbReader;
     GuiMock gui;
 
-    EXPECT_CALL(dbReader, IsEmpty()).WillOnce(Return(false));
-    EXPECT_CALL(dbReader, CheckHeader()).WillOnce(Return(true));
-    EXPECT_CALL(dbReader, GetFormatReadVersion()).WillOnce(Return(g_testHeader.bytesOfUnused));
-    EXPECT_CALL(gui, DisplayHeader(_)).Times(1);
+    ExpectValidHeader(dbReader);
+    EXPECT_CALL(gui, DisplayHeader(Contains("Unused bytes - 0"))).Times(1);
 
     ASSERT_NO_THROW(DysplayHeaderStructure(&gui, &dbReader));
 }
@@ -200,10 +163,8 @@ TEST(SqliteHeaderReader, ReadMaximumEmbeddedPayloadFraction)
     DbReaderMock dbReader;
     GuiMock gui;
 
-    EXPECT_CALL(dbReader, IsEmpty()).WillOnce(Return(false));
-    EXPECT_CALL(dbReader, CheckHeader()).WillOnce(Return(true));
-    EXPECT_CALL(dbReader, GetMaximumEmbeddedPayloadFraction()).WillOnce(Return(g_testHeader.maximumEmbeddedPayloadFraction));
-    EXPECT_CALL(gui, DisplayHeader(_)).Times(1);
+    ExpectValidHeader(dbReader);
+    EXPECT_CALL(gui, DisplayHeader(Contains("Maximum embedded payload fraction - 64"))).Times(1);
 
     ASSERT_NO_THROW(DysplayHeaderStructure(&gui, &dbReader));
 }
@@ -213,10 +174,8 @@ TEST(SqliteHeaderReader, ReadMinimumEmbeddedPayloadFraction)
     DbReaderMock dbReader;
     GuiMock gui;
 
-    EXPECT_CALL(dbReader, IsEmpty()).WillOnce(Return(false));
-    EXPECT_CALL(dbReader, CheckHeader()).WillOnce(Return(true));
-    EXPECT_CALL(dbReader, GetMinimumEmbeddedPayloadFraction()).WillOnce(Return(g_testHeader.minimumEmbeddedPayloadFraction));
-    EXPECT_CALL(gui, DisplayHeader(_)).Times(1);
+    ExpectValidHeader(dbReader);
+    EXPECT_CALL(gui, DisplayHeader(Contains("Minimum embedded payload fraction - 32"))).Times(1);
 
     ASSERT_NO_THROW(DysplayHeaderStructure(&gui, &dbReader));
 }
@@ -226,10 +185,8 @@ TEST(SqliteHeaderReader, ReadLeafPayloadFraction)
     DbReaderMock dbReader;
     GuiMock gui;
 
-    EXPECT_CALL(dbReader, IsEmpty()).WillOnce(Return(false));
-    EXPECT_CALL(dbReader, CheckHeader()).WillOnce(Return(true));
-    EXPECT_CALL(dbReader, GetLeafPayloadFraction()).WillOnce(Return(g_testHeader.leafPayloadFraction));
-    EXPECT_CALL(gui, DisplayHeader(_)).Times(1);
+    ExpectValidHeader(dbReader);
+    EXPECT_CALL(gui, DisplayHeader(Contains("Leaf payload fraction - 32"))).Times(1);
 
     ASSERT_NO_THROW(DysplayHeaderStructure(&gui, &dbReader));
 }
@@ -239,10 +196,8 @@ TEST(SqliteHeaderReader, ReadFileChangeCounter)
     DbReaderMock dbReader;
     GuiMock gui;
 
-    EXPECT_CALL(dbReader, IsEmpty()).WillOnce(Return(false));
-    EXPECT_CALL(dbReader, CheckHeader()).WillOnce(Return(true));
-    EXPECT_CALL(dbReader, GetFileChangeCounter()).WillOnce(Return(g_testHeader.fileChangeCounter));
-    EXPECT_CALL(gui, DisplayHeader(_)).Times(1);
+    ExpectValidHeader(dbReader);
+    EXPECT_CALL(gui, DisplayHeader(Contains("File change counter - 1"))).Times(1);
 
     ASSERT_NO_THROW(DysplayHeaderStructure(&gui, &dbReader));
 }
@@ -252,10 +207,8 @@ TEST(SqliteHeaderReader, ReadPageCount)
     DbReaderMock dbReader;
     GuiMock gui;
 
-    EXPECT_CALL(dbReader, IsEmpty()).WillOnce(Return(false));
-    EXPECT_CALL(dbReader, CheckHeader()).WillOnce(Return(true));
-    EXPECT_CALL(dbReader, GetPageCount()).WillOnce(Return(g_testHeader.pageCount));
-    EXPECT_CALL(gui, DisplayHeader(_)).Times(1);
+    ExpectValidHeader(dbReader);
+    EXPECT_CALL(gui, DisplayHeader(Contains("Size of the database file in pages - 30"))).Times(1);
 
     ASSERT_NO_THROW(DysplayHeaderStructure(&gui, &dbReader));
 }
@@ -265,10 +218,8 @@ TEST(SqliteHeaderReader, ReadFirstFreelistPage)
     DbReaderMock dbReader;
     GuiMock gui;
 
-    EXPECT_CALL(dbReader, IsEmpty()).WillOnce(Return(false));
-    EXPECT_CALL(dbReader, CheckHeader()).WillOnce(Return(true));
-    EXPECT_CALL(dbReader, GetFirstFreelistPage()).WillOnce(Return(g_testHeader.firstFreelistPage));
-    EXPECT_CALL(gui, DisplayHeader(_)).Times(1);
+    ExpectValidHeader(dbReader);
+    EXPECT_CALL(gui, DisplayHeader(Contains("Page number of the first freelist trunk page - 20"))).Times(1);
 
     ASSERT_NO_THROW(DysplayHeaderStructure(&gui, &dbReader));
 }
@@ -278,10 +229,8 @@ TEST(SqliteHeaderReader, ReadFreelistPageCount)
     DbReaderMock dbReader;
     GuiMock gui;
 
-    EXPECT_CALL(dbReader, IsEmpty()).WillOnce(Return(false));
-    EXPECT_CALL(dbReader, CheckHeader()).WillOnce(Return(true));
-    EXPECT_CALL(dbReader, GetFreelistPageCount()).WillOnce(Return(g_testHeader.freelistPageCount));
-    EXPECT_CALL(gui, DisplayHeader(_)).Times(1);
+    ExpectValidHeader(dbReader);
+    EXPECT_CALL(gui, DisplayHeader(Contains("Total number of freelist pages - 5"))).Times(1);
 
     ASSERT_NO_THROW(DysplayHeaderStructure(&gui, &dbReader));
 }
@@ -291,10 +240,8 @@ TEST(SqliteHeaderReader, ReadSchemaFormat)
     DbReaderMock dbReader;
     GuiMock gui;
 
-    EXPECT_CALL(dbReader, IsEmpty()).WillOnce(Return(false));
-    EXPECT_CALL(dbReader, CheckHeader()).WillOnce(Return(true));
-    EXPECT_CALL(dbReader, GetSchemaFormat()).WillOnce(Return(g_testHeader.schemaFormat));
-    EXPECT_CALL(gui, DisplayHeader(_)).Times(1);
+    ExpectValidHeader(dbReader);
+    EXPECT_CALL(gui, DisplayHeader(Contains("The schema format number - 1"))).Times(1);
 
     ASSERT_NO_THROW(DysplayHeaderStructure(&gui, &dbReader));
 }
@@ -304,10 +251,8 @@ TEST(SqliteHeaderReader, ReadDefaultPageCacheSize)
     DbReaderMock dbReader;
     GuiMock gui;
 
-    EXPECT_CALL(dbReader, IsEmpty()).WillOnce(Return(false));
-    EXPECT_CALL(dbReader, CheckHeader()).WillOnce(Return(true));
-    EXPECT_CALL(dbReader, GetDefaultPageCacheSize()).WillOnce(Return(g_testHeader.defaultPageCacheSize));
-    EXPECT_CALL(gui, DisplayHeader(_)).Times(1);
+    ExpectValidHeader(dbReader);
+    EXPECT_CALL(gui, DisplayHeader(Contains("Default page cache size - 32"))).Times(1);
 
     ASSERT_NO_THROW(DysplayHeaderStructure(&gui, &dbReader));
 }
@@ -317,10 +262,8 @@ TEST(SqliteHeaderReader, ReadNumberOfLargestRootPage)
     DbReaderMock dbReader;
     GuiMock gui;
 
-    EXPECT_CALL(dbReader, IsEmpty()).WillOnce(Return(false));
-    EXPECT_CALL(dbReader, CheckHeader()).WillOnce(Return(true));
-    EXPECT_CALL(dbReader, GetNumberOfLargestRootPage()).WillOnce(Return(g_testHeader.numberOfLargestRootPage));
-    EXPECT_CALL(gui, DisplayHeader(_)).Times(1);
+    ExpectValidHeader(dbReader);
+    EXPECT_CALL(gui, DisplayHeader(Contains("The page number of the largest root b-tree page - 0"))).Times(1);
 
     ASSERT_NO_THROW(DysplayHeaderStructure(&gui, &dbReader));
 }
@@ -330,10 +273,8 @@ TEST(SqliteHeaderReader, ReadDatabaseTextEncoding)
     DbReaderMock dbReader;
     GuiMock gui;
 
-    EXPECT_CALL(dbReader, IsEmpty()).WillOnce(Return(false));
-    EXPECT_CALL(dbReader, CheckHeader()).WillOnce(Return(true));
-    EXPECT_CALL(dbReader, GetDatabaseTextEncoding()).WillOnce(Return(g_testHeader.databaseTextEncoding));
-    EXPECT_CALL(gui, DisplayHeader(_)).Times(1);
+    ExpectValidHeader(dbReader);
+    EXPECT_CALL(gui, DisplayHeader(Contains("The database text encoding - 1"))).Times(1);
 
     ASSERT_NO_THROW(DysplayHeaderStructure(&gui, &dbReader));
 }
@@ -343,10 +284,8 @@ TEST(SqliteHeaderReader, ReadUserVersion)
     DbReaderMock dbReader;
     GuiMock gui;
 
-    EXPECT_CALL(dbReader, IsEmpty()).WillOnce(Return(false));
-    EXPECT_CALL(dbReader, CheckHeader()).WillOnce(Return(true));
-    EXPECT_CALL(dbReader, GetUserVersion()).WillOnce(Return(g_testHeader.userVersion));
-    EXPECT_CALL(gui, DisplayHeader(_)).Times(1);
+    ExpectValidHeader(dbReader);
+    EXPECT_CALL(gui, DisplayHeader(Contains("The \"user version\" - 2"))).Times(1);
 
     ASSERT_NO_THROW(DysplayHeaderStructure(&gui, &dbReader));
 }
@@ -356,10 +295,8 @@ TEST(SqliteHeaderReader, ReadIncrementalVacuumMode)
     DbReaderMock dbReader;
     GuiMock gui;
 
-    EXPECT_CALL(dbReader, IsEmpty()).WillOnce(Return(false));
-    EXPECT_CALL(dbReader, CheckHeader()).WillOnce(Return(true));
-    EXPECT_CALL(dbReader, GetIncrementalVacuumMode()).WillOnce(Return(g_testHeader.incrementalVacuumMode));
-    EXPECT_CALL(gui, DisplayHeader(_)).Times(1);
+    ExpectValidHeader(dbReader);
+    EXPECT_CALL(gui, DisplayHeader(Contains("The vacuum mode - 0"))).Times(1);
 
     ASSERT_NO_THROW(DysplayHeaderStructure(&gui, &dbReader));
 }
@@ -369,10 +306,8 @@ TEST(SqliteHeaderReader, ReadApplicationId)
     DbReaderMock dbReader;
     GuiMock gui;
 
-    EXPECT_CALL(dbReader, IsEmpty()).WillOnce(Return(false));
-    EXPECT_CALL(dbReader, CheckHeader()).WillOnce(Return(true));
-    EXPECT_CALL(dbReader, GetApplicationId()).WillOnce(Return(g_testHeader.applicationId));
-    EXPECT_CALL(gui, DisplayHeader(_)).Times(1);
+    ExpectValidHeader(dbReader);
+    EXPECT_CALL(gui, DisplayHeader(Contains("The \"Application ID\" - 33"))).Times(1);
 
     ASSERT_NO_THROW(DysplayHeaderStructure(&gui, &dbReader));
 }
@@ -382,10 +317,8 @@ TEST(SqliteHeaderReader, ReadVersionValidNumber)
     DbReaderMock dbReader;
     GuiMock gui;
 
-    EXPECT_CALL(dbReader, IsEmpty()).WillOnce(Return(false));
-    EXPECT_CALL(dbReader, CheckHeader()).WillOnce(Return(true));
-    EXPECT_CALL(dbReader, GetVersionValidNumber()).WillOnce(Return(g_testHeader.versionValidNumber));
-    EXPECT_CALL(gui, DisplayHeader(_)).Times(1);
+    ExpectValidHeader(dbReader);
+    EXPECT_CALL(gui, DisplayHeader(Contains("The version-valid-for number - 3"))).Times(1);
 
     ASSERT_NO_THROW(DysplayHeaderStructure(&gui, &dbReader));
 }
@@ -395,17 +328,15 @@ TEST(SqliteHeaderReader, ReadSqliteVersionNumber)
     DbReaderMock dbReader;
     GuiMock gui;
 
-    EXPECT_CALL(dbReader, IsEmpty()).WillOnce(Return(false));
-    EXPECT_CALL(dbReader, CheckHeader()).WillOnce(Return(true));
-    EXPECT_CALL(dbReader, GetSqliteVersionNumber()).WillOnce(Return(g_testHeader.sqliteVersionNumber));
-    EXPECT_CALL(gui, DisplayHeader(_)).Times(1);
+    ExpectValidHeader(dbReader);
+    EXPECT_CALL(gui, DisplayHeader(Contains("The SQLITE_VERSION_NUMBER - 22"))).Times(1);
 
     ASSERT_NO_THROW(DysplayHeaderStructure(&gui, &dbReader));
 }
 
 TEST(SqliteHeaderReader, SummaryTest)
 {
-    DbReaderMock dbReader;
+    StrictMock<DbReaderMock> dbReader; // no per-field getter may be called
     EXPECT_CALL(dbReader, ReadFilePath("somePath")).WillOnce(Return(true));
     dbReader.ReadFilePath("somePath");
     GuiMock gui;
@@ -433,29 +364,7 @@ TEST(SqliteHeaderReader, SummaryTest)
                 std::string("The version-valid-for number - 3"),
                 std::string("The SQLITE_VERSION_NUMBER - 22")};
 
-    EXPECT_CALL(dbReader, IsEmpty()).WillOnce(Return(false));
-    EXPECT_CALL(dbReader, CheckHeader()).WillOnce(Return(true));
-    EXPECT_CALL(dbReader, GetHeaderString()).WillOnce(Return(g_testHeader.head));
-    EXPECT_CALL(dbReader, GetPageSize()).WillOnce(Return(g_testHeader.pageSize));
-    EXPECT_CALL(dbReader, GetFormatWriteVersion()).WillOnce(Return(g_testHeader.fileFormatWriteVersion));
-    EXPECT_CALL(dbReader, GetFormatReadVersion()).WillOnce(Return(g_testHeader.fileFormatReadVersion));
-    EXPECT_CALL(dbReader, GetFormatReadVersion()).WillOnce(Return(g_testHeader.bytesOfUnused));
-    EXPECT_CALL(dbReader, GetMaximumEmbeddedPayloadFraction()).WillOnce(Return(g_testHeader.maximumEmbeddedPayloadFraction));
-    EXPECT_CALL(dbReader, GetMinimumEmbeddedPayloadFraction()).WillOnce(Return(g_testHeader.minimumEmbeddedPayloadFraction));
-    EXPECT_CALL(dbReader, GetLeafPayloadFraction()).WillOnce(Return(g_testHeader.leafPayloadFraction));
-    EXPECT_CALL(dbReader, GetFileChangeCounter()).WillOnce(Return(g_testHeader.fileChangeCounter));
-    EXPECT_CALL(dbReader, GetPageCount()).WillOnce(Return(g_testHeader.pageCount));
-    EXPECT_CALL(dbReader, GetFirstFreelistPage()).WillOnce(Return(g_testHeader.firstFreelistPage));
-    EXPECT_CALL(dbReader, GetFreelistPageCount()).WillOnce(Return(g_testHeader.freelistPageCount));
-    EXPECT_CALL(dbReader, GetSchemaFormat()).WillOnce(Return(g_testHeader.schemaFormat));
-    EXPECT_CALL(dbReader, GetDefaultPageCacheSize()).WillOnce(Return(g_testHeader.defaultPageCacheSize));
-    EXPECT_CALL(dbReader, GetNumberOfLargestRootPage()).WillOnce(Return(g_testHeader.numberOfLargestRootPage));
-    EXPECT_CALL(dbReader, GetDatabaseTextEncoding()).WillOnce(Return(g_testHeader.databaseTextEncoding));
-    EXPECT_CALL(dbReader, GetUserVersion()).WillOnce(Return(g_testHeader.userVersion));
-    EXPECT_CALL(dbReader, GetIncrementalVacuumMode()).WillOnce(Return(g_testHeader.incrementalVacuumMode));
-    EXPECT_CALL(dbReader, GetApplicationId()).WillOnce(Return(g_testHeader.applicationId));
-    EXPECT_CALL(dbReader, GetVersionValidNumber()).WillOnce(Return(g_testHeader.versionValidNumber));
-    EXPECT_CALL(dbReader, GetSqliteVersionNumber()).WillOnce(Return(g_testHeader.sqliteVersionNumber));
+    ExpectValidHeader(dbReader);
 
     EXPECT_CALL(gui, DisplayHeader(expectedData)).Times(1);
 
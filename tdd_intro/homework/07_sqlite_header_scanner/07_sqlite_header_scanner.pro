@@ -0,0 +1,45 @@
+TEMPLATE = app
+CONFIG += console c++17 thread release
+CONFIG -= app_bundle
+CONFIG -= qt
+
+INCLUDEPATH += ../07_sqlite_header_parser
+
+SOURCES += \
+    main.cpp \
+    ../07_sqlite_header_parser/DbReader.cpp \
+    ../07_sqlite_header_parser/FileIo.cpp \
+    ../07_sqlite_header_parser/HeaderBatchReader.cpp \
+    ../07_sqlite_header_parser/HeaderCache.cpp \
+    ../07_sqlite_header_parser/HeaderDisplay.cpp \
+    ../07_sqlite_header_parser/HeaderScanner.cpp \
+    ../07_sqlite_header_parser/PageReader.cpp \
+    ../07_sqlite_header_parser/FreelistAnalyzer.cpp \
+    ../07_sqlite_header_parser/HeaderWatcher.cpp \
+    ../07_sqlite_header_parser/WalIndex.cpp \
+    ../07_sqlite_header_parser/HeaderFormatter.cpp \
+    ../07_sqlite_header_parser/HeaderValidator.cpp \
+    ../07_sqlite_header_parser/SchemaReader.cpp \
+    ../07_sqlite_header_parser/Xxh64.cpp \
+    ../07_sqlite_header_parser/PageHasher.cpp \
+    ../07_sqlite_header_parser/BtreeStats.cpp
+
+HEADERS += \
+    ../07_sqlite_header_parser/Interfaces.h \
+    ../07_sqlite_header_parser/SqliteFormat.h \
+    ../07_sqlite_header_parser/FileIo.h \
+    ../07_sqlite_header_parser/HeaderBatchReader.h \
+    ../07_sqlite_header_parser/HeaderCache.h \
+    ../07_sqlite_header_parser/DbReader.h \
+    ../07_sqlite_header_parser/HeaderDisplay.h \
+    ../07_sqlite_header_parser/HeaderScanner.h \
+    ../07_sqlite_header_parser/PageReader.h \
+    ../07_sqlite_header_parser/FreelistAnalyzer.h \
+    ../07_sqlite_header_parser/HeaderWatcher.h \
+    ../07_sqlite_header_parser/WalIndex.h \
+    ../07_sqlite_header_parser/HeaderFormatter.h \
+    ../07_sqlite_header_parser/HeaderValidator.h \
+    ../07_sqlite_header_parser/SchemaReader.h \
+    ../07_sqlite_header_parser/Xxh64.h \
+    ../07_sqlite_header_parser/PageHasher.h \
+    ../07_sqlite_header_parser/BtreeStats.h
@@ -0,0 +1,348 @@
+/*
+Displays the header of a single database or validates every database header under a directory.
+
+Usage: 07_sqlite_header_scanner <file or directory> [threads] [--jsonl | --csv] [--no-io-uring]
+                                [--cache <file>]
+       07_sqlite_header_scanner --watch <file>...
+       07_sqlite_header_scanner --manifest <database> <manifest>
+       07_sqlite_header_scanner --diff <manifest before> <manifest after>
+       07_sqlite_header_scanner --btree-stats <database>
+
+Nothing is opened through the sqlite library. For a single file the schema is listed, the
+freelist is walked to report the space VACUUM would reclaim and the WAL of a database in WAL
+mode is indexed to bound the pages waiting for a checkpoint (the -shm file is not read, so
+pages already checkpointed are counted too). An analysis that fails is named on stderr, the
+others still run and the exit status is failure.
+A directory scan reads only the first 100 bytes of each file. The summary lists the page size distribution, WAL versus legacy databases and
+every file with a broken header. On Linux the reads go through io_uring unless --no-io-uring
+is given or the kernel does not allow it. With --cache the first bytes of every file are
+kept in the given cache file keyed by device, inode, size and modification time, so a rescan
+of an unchanged tree only stats the files. With --jsonl or --csv every valid header under the
+directory is written to stdout as a JSON line or a CSV row and the summary goes to stderr.
+The watch mode keeps the files open and prints a line whenever a file change counter moves.
+The manifest mode hashes every page of a database and writes the hashes to a manifest file,
+the diff mode compares two manifests of one database and lists the pages that are new or
+changed in the second one. It exits with failure when any page differs, like diff does.
+The b-tree stats mode reads a database once front to back and prints the pages, cells and
+fill factor of every page kind and the overflow pages the cells spill into.
+*/
+
+#include <chrono>
+#include <iomanip>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+
+#include "BtreeStats.h"
+#include "DbReader.h"
+#include "FreelistAnalyzer.h"
+#include "HeaderDisplay.h"
+#include "HeaderCache.h"
+#include "HeaderFormatter.h"
+#include "HeaderScanner.h"
+#include "HeaderValidator.h"
+#include "HeaderWatcher.h"
+#include "PageHasher.h"
+#include "SchemaReader.h"
+#include "WalIndex.h"
+
+namespace
+{
+    class ConsoleGui : public IGui
+    {
+    public:
+        void DisplayHeader(const std::vector<std::string>& header)
+        {
+            for (const std::string& line : header)
+            {
+                std::cout << line << '\n';
+            }
+        }
+    };
+
+    void PrintSummary(std::ostream& out, const ScanSummary& summary, double seconds)
+    {
+        out << "Files visited - " << summary.filesVisited << '\n'
+                  << "SQLite databases - " << summary.sqliteFiles << '\n'
+                  << "WAL mode - " << summary.walFiles << '\n'
+                  << "Legacy mode - " << summary.legacyFiles << '\n'
+                  << "Cache hits - " << summary.cacheHits << '\n'
+                  << "Page sizes:\n";
+        for (const auto& pageSize : summary.pageSizes)
+        {
+            out << "    " << pageSize.first << " - " << pageSize.second << '\n';
+        }
+        out << "Bad headers - " << summary.badHeaders.size() << '\n';
+        for (const std::string& badHeader : summary.badHeaders)
+        {
+            out << "    " << badHeader << '\n';
+        }
+        if (!summary.walkErrors.empty())
+        {
+            out << "Directories not scanned - " << summary.walkErrors.size() << '\n';
+            for (const std::string& walkError : summary.walkErrors)
+            {
+                out << "    " << walkError << '\n';
+            }
+        }
+        out << "Scanned in " << seconds << " s\n";
+    }
+
+    void PrintUsage(const char* program)
+    {
+        std::cerr << "Usage: " << program << " <file or directory> [threads] [--jsonl | --csv] [--no-io-uring] [--cache <file>]\n"
+                  << "       " << program << " --watch <file>...\n"
+                  << "       " << program << " --manifest <database> <manifest>\n"
+                  << "       " << program << " --diff <manifest before> <manifest after>\n"
+                  << "       " << program << " --btree-stats <database>\n";
+    }
+
+    int WriteManifest(const std::string& databasePath, const std::string& manifestPath)
+    {
+        const PageManifest manifest = HashPages(databasePath);
+        WritePageManifest(manifestPath, manifest);
+        std::cout << "Pages hashed - " << manifest.pageHashes.size() << '\n';
+        return EXIT_SUCCESS;
+    }
+
+    int DiffManifestFiles(const std::string& beforePath, const std::string& afterPath)
+    {
+        const PageManifest before = ReadPageManifest(beforePath);
+        const PageManifest after = ReadPageManifest(afterPath);
+        const std::vector<uint32_t> changedPages = DiffManifests(before, after);
+        std::cout << "Pages before - " << before.pageHashes.size() << '\n'
+                  << "Pages after - " << after.pageHashes.size() << '\n'
+                  << "Changed pages - " << changedPages.size() << '\n';
+        for (uint32_t page : changedPages)
+        {
+            std::cout << "    " << page << '\n';
+        }
+        const bool same = changedPages.empty() && before.pageHashes.size() == after.pageHashes.size();
+        return same ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    int PrintBtreeStats(const std::string& databasePath)
+    {
+        const BtreeStats stats = CollectBtreeStats(databasePath);
+        const char* const kindNames[g_pageKindsCount] = {"Interior index", "Interior table", "Leaf index",
+                                                         "Leaf table", "Other"};
+        std::cout << "Page size - " << stats.pageSize << '\n'
+                  << "Pages scanned - " << stats.pagesScanned << '\n';
+        for (size_t kind = 0; kind < g_pageKindsCount; ++kind)
+        {
+            const PageKindStats& kindStats = stats.kinds[kind];
+            std::cout << kindNames[kind] << " pages - " << kindStats.pages;
+            if (static_cast<PageKind>(kind) != PageKind::Other)
+            {
+                std::cout << ", cells - " << kindStats.cells << ", fill factor - " << std::fixed
+                          << std::setprecision(3) << kindStats.FillFactor();
+            }
+            std::cout << '\n';
+        }
+        std::cout << "Overflow chains - " << stats.overflowChains << '\n'
+                  << "Overflow pages - " << stats.overflowPages << '\n'
+                  << "Corrupt pages - " << stats.corruptPages << '\n';
+        return stats.corruptPages == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // Runs one analysis of a database whose header was already printed, a failure names the analysis
+    template <typename Analysis>
+    bool RunAnalysis(const std::string& path, const char* name, Analysis analysis)
+    {
+        try
+        {
+            analysis();
+            return true;
+        }
+        catch (const std::exception& error)
+        {
+            std::cerr << path << ": " << name << " could not be read - " << error.what() << '\n';
+            return false;
+        }
+    }
+
+    int DescribeDatabase(const std::string& path)
+    {
+        DbReader dbReader;
+        ConsoleGui gui;
+        try
+        {
+            dbReader.ReadFilePath(path);
+            DysplayHeaderStructure(&gui, &dbReader);
+        }
+        catch (const std::exception&)
+        {
+            std::cerr << path << ": not a valid SQLite database\n";
+            return EXIT_FAILURE;
+        }
+        for (const std::string& message : DescribeViolations(dbReader.GetViolations()))
+        {
+            std::cout << "Violation - " << message << '\n';
+        }
+        bool complete = RunAnalysis(path, "schema", [&path]()
+        {
+            for (const SchemaEntry& entry : ReadSchema(path))
+            {
+                std::cout << "Schema " << entry.type << " - " << entry.name << '\n';
+            }
+        });
+        complete = RunAnalysis(path, "freelist", [&path]()
+        {
+            const FreelistReport freelist = AnalyzeFreelist(path);
+            std::cout << "Reclaimable bytes - " << freelist.reclaimableBytes
+                      << (freelist.consistent ? "" : " (freelist is damaged)") << '\n';
+        }) && complete;
+        if (dbReader.GetFormatWriteVersion() == 2 && std::filesystem::exists(WalPathFor(path)))
+        {
+            complete = RunAnalysis(path, "WAL", [&path]()
+            {
+                const WalIndex wal = ParseWal(WalPathFor(path));
+                std::cout << "Pages pending checkpoint, at most - " << wal.PendingCheckpointPages() << '\n';
+            }) && complete;
+        }
+        return complete ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    int Watch(int count, char* paths[])
+    {
+        HeaderWatcher watcher;
+        for (int i = 0; i < count; ++i)
+        {
+            if (!watcher.Add(paths[i]))
+            {
+                std::cerr << paths[i] << ": not a valid SQLite database\n";
+            }
+        }
+        if (watcher.Size() == 0)
+        {
+            return EXIT_FAILURE;
+        }
+        while (true)
+        {
+            watcher.Wait([](const HeaderChange& change)
+            {
+                std::cout << change.filePath << " - " << change.oldChangeCounter << " -> "
+                          << change.newChangeCounter << std::endl;
+            }, 1000);
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        PrintUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    const std::string mode = argv[1];
+    if (mode == "--watch")
+    {
+        return Watch(argc - 2, argv + 2);
+    }
+    if (mode == "--btree-stats")
+    {
+        if (argc != 3)
+        {
+            PrintUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        try
+        {
+            return PrintBtreeStats(argv[2]);
+        }
+        catch (const std::exception& error)
+        {
+            std::cerr << error.what() << '\n';
+            return EXIT_FAILURE;
+        }
+    }
+    if (mode == "--manifest" || mode == "--diff")
+    {
+        if (argc != 4)
+        {
+            PrintUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        try
+        {
+            return mode == "--manifest" ? WriteManifest(argv[2], argv[3]) : DiffManifestFiles(argv[2], argv[3]);
+        }
+        catch (const std::exception& error)
+        {
+            std::cerr << error.what() << '\n';
+            return EXIT_FAILURE;
+        }
+    }
+    const std::string path = argv[1];
+    size_t threads = 0;
+    bool useIoUring = true;
+    std::string cachePath;
+    std::unique_ptr<IHeaderFormatter> formatter;
+    for (int i = 2; i < argc; ++i)
+    {
+        const std::string option = argv[i];
+        if (option == "--jsonl")
+        {
+            formatter.reset(new JsonLinesHeaderFormatter(std::cout));
+        }
+        else if (option == "--csv")
+        {
+            formatter.reset(new CsvHeaderFormatter(std::cout));
+        }
+        else if (option == "--no-io-uring")
+        {
+            useIoUring = false;
+        }
+        else if (option == "--cache" && i + 1 < argc)
+        {
+            cachePath = argv[++i];
+        }
+        else if (!option.empty() && option.find_first_not_of("0123456789") == std::string::npos)
+        {
+            threads = std::strtoul(argv[i], nullptr, 10);
+        }
+        else
+        {
+            PrintUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::error_code error;
+    if (!std::filesystem::is_directory(path, error))
+    {
+        return DescribeDatabase(path);
+    }
+    try
+    {
+        const auto start = std::chrono::steady_clock::now();
+        HeaderCache cache;
+        if (!cachePath.empty())
+        {
+            cache.Load(cachePath);
+        }
+        const ScanSummary summary = HeaderScanner(threads, 256, useIoUring).Scan(path, formatter.get(),
+                                                                                 cachePath.empty() ? nullptr : &cache);
+        if (!cachePath.empty())
+        {
+            try
+            {
+                cache.Save(cachePath);
+            }
+            catch (const std::exception& error)
+            {
+                std::cerr << error.what() << '\n';
+            }
+        }
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        PrintSummary(formatter ? std::cerr : std::cout, summary, elapsed.count());
+        return summary.badHeaders.empty() && summary.walkErrors.empty() ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    catch (const std::exception& error)
+    {
+        std::cerr << path << ": " << error.what() << '\n';
+        return EXIT_FAILURE;
+    }
+}
@@ -4,7 +4,11 @@ SUBDIRS += \
     01_leap_year \
     02_ternary_numbers \
     03_bank_ocr \
+    03_bank_ocr_benchmark \
     04_weather_client \
     05_word_wrapp \
     06_coffee \
-    07_sqlite_header_parser
+    07_sqlite_header_parser \
+    07_sqlite_header_scanner \
+    07_sqlite_header_fuzzer \
+    07_sqlite_header_benchmark